@@ -0,0 +1,433 @@
+// Banco de pruebas de rendimiento de los tres programas: ListadoEstudiantil, SenalECG y JuegoDomino.
+// Genera datos sintéticos, mide cada operación por separado e informa ops/s, percentiles de latencia,
+// reservas de memoria por operación y RSS pico. Los resultados se guardan en JSON y se pueden
+// comparar contra una base guardada antes (ver --ayuda).
+#include "listado_estudiantil.h"
+#include "senal_ecg.h"
+#include "juego_domino.h"
+
+#include <new>
+#include <atomic>
+#include <sstream>
+#include <set>
+#include <numeric>
+#include <iomanip>
+#include <ctime>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Conteo de reservas de memoria (atómico: el pool de la señal y el exportador usan hilos)
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"  // new/delete reemplazados usan malloc/free a propósito
+#endif
+static atomic<size_t> g_reservas(0), g_bytes(0);
+void* operator new(size_t n) {
+    g_reservas.fetch_add(1, memory_order_relaxed);
+    g_bytes.fetch_add(n, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Los resultados de las consultas se acumulan aquí para que el optimizador no las descarte
+static volatile size_t g_sumidero;
+
+// RSS pico del proceso en KiB (crece de forma monótona: para aislar un caso use --solo)
+size_t rssPicoKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof pmc)) return 0;
+    return pmc.PeakWorkingSetSize / 1024;
+#else
+    rusage u;
+    getrusage(RUSAGE_SELF, &u);
+#ifdef __APPLE__
+    return u.ru_maxrss / 1024;  // macOS informa bytes
+#else
+    return u.ru_maxrss;
+#endif
+#endif
+}
+
+struct Resultado {
+    string nombre;
+    size_t ops;
+    double segundos;
+    double p50, p90, p99, maximo;  // µs por operación
+    double reservasOp, bytesOp;
+    size_t rssPicoKB;
+
+    double opsSeg() const { return segundos > 0 ? ops / segundos : 0; }
+};
+
+// Opciones de la corrida
+struct Opciones {
+    vector<double> estudiantes = { 1e3, 1e4, 1e5 };
+    vector<double> ecgHz = { 250, 500, 1000 };
+    vector<double> ecgMinutos = { 1, 10 };
+    int rondas = 20000;
+    string solo;                       // subcadena de la configuración a correr
+    string salida = "benchmark_resultados.json";
+    string base;                       // JSON contra el que se compara
+    double tolerancia = 15;            // % de caída de ops/s aceptada
+};
+
+// Banco: corre operaciones, guarda resultados e imprime una fila por caso
+class Banco {
+private:
+    Opciones opc;
+    vector<Resultado> resultados;
+    ostringstream descarte;            // salida de consola de las clases durante la medición
+
+    static double percentil(const vector<double>& v, double p) {
+        if (v.empty()) return 0;
+        size_t k = (size_t)ceil(p * v.size());
+        return v[k > 0 ? k - 1 : 0];
+    }
+
+public:
+    explicit Banco(const Opciones& o) : opc(o) {}
+
+    const vector<Resultado>& todos() const { return resultados; }
+
+    // ¿Se corre esta configuración? (la preparación de datos se omite si no)
+    bool activa(const string& config) const { return opc.solo.empty() || config.find(opc.solo) != string::npos; }
+
+    // Cronometra 'ops' llamadas a op(i) por separado. Las reservas cuentan solo dentro de op
+    template <class F>
+    void medir(const string& nombre, size_t ops, F op) {
+        vector<double> lat(ops);
+        streambuf* original = cout.rdbuf(descarte.rdbuf());
+        size_t r0 = g_reservas.load(), b0 = g_bytes.load();
+        auto inicio = chrono::steady_clock::now();
+        for (size_t i = 0; i < ops; ++i) {
+            auto t0 = chrono::steady_clock::now();
+            op(i);
+            lat[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        }
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        size_t reservas = g_reservas.load() - r0, bytes = g_bytes.load() - b0;
+        cout.rdbuf(original);
+        descarte.str("");
+
+        sort(lat.begin(), lat.end());
+        Resultado r;
+        r.nombre = nombre;
+        r.ops = ops;
+        r.segundos = seg;
+        r.p50 = percentil(lat, 0.50);
+        r.p90 = percentil(lat, 0.90);
+        r.p99 = percentil(lat, 0.99);
+        r.maximo = lat.empty() ? 0 : lat.back();
+        r.reservasOp = ops ? (double)reservas / ops : 0;
+        r.bytesOp = ops ? (double)bytes / ops : 0;
+        r.rssPicoKB = rssPicoKB();
+        resultados.push_back(r);
+        imprimir(r);
+    }
+
+    static void encabezado() {
+        cout << left << setw(44) << "caso" << right << setw(10) << "ops" << setw(14) << "ops/s"
+             << setw(11) << "p50 µs" << setw(11) << "p90 µs" << setw(11) << "p99 µs" << setw(12) << "máx µs"
+             << setw(12) << "reservas/op" << setw(11) << "RSS MiB" << "\n";
+    }
+
+    static void imprimir(const Resultado& r) {
+        cout << left << setw(44) << r.nombre << right << setw(10) << r.ops << fixed << setprecision(0)
+             << setw(14) << r.opsSeg() << setprecision(2) << setw(11) << r.p50 << setw(11) << r.p90
+             << setw(11) << r.p99 << setw(12) << r.maximo << setw(12) << r.reservasOp << setprecision(1)
+             << setw(11) << r.rssPicoKB / 1024.0 << defaultfloat << setprecision(6) << "\n";
+    }
+
+    // Un caso por línea, para que la comparación pueda leerlo sin un analizador de JSON
+    bool guardarJSON(const string& nombre) const {
+        ofstream os(nombre);
+        if (!os.is_open()) return false;
+        os << "{\n  \"compilador\": \"" << __VERSION__ << "\",\n  \"hilos\": " << thread::hardware_concurrency()
+           << ",\n  \"fecha\": " << (long long)time(nullptr) << ",\n  \"casos\": [\n";
+        for (size_t i = 0; i < resultados.size(); ++i) {
+            const Resultado& r = resultados[i];
+            os << "    {\"nombre\": \"" << r.nombre << "\", \"ops\": " << r.ops << ", \"segundos\": " << r.segundos
+               << ", \"ops_s\": " << r.opsSeg() << ", \"p50_us\": " << r.p50 << ", \"p90_us\": " << r.p90
+               << ", \"p99_us\": " << r.p99 << ", \"max_us\": " << r.maximo << ", \"reservas_op\": " << r.reservasOp
+               << ", \"bytes_op\": " << r.bytesOp << ", \"rss_pico_kb\": " << r.rssPicoKB << "}"
+               << (i + 1 < resultados.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+        return true;
+    }
+};
+
+// ---------- Generadores ----------
+
+// Estudiante sintético: nombre de tres partes, email único, año y promedio al azar
+Estudiante estudianteSintetico(mt19937& rng, int id) {
+    static const char* const NOMBRES[] = { "Ana", "Juan", "Maria", "Carlos", "Laura", "Andres", "Sofia", "Diego",
+                                           "Valentina", "Santiago", "Camila", "Felipe", "Daniela", "Mateo",
+                                           "Isabella", "Sebastian", "Paula", "Nicolas", "Natalia", "Julian" };
+    static const char* const APELLIDOS[] = { "Garcia", "Rodriguez", "Martinez", "Lopez", "Gonzalez", "Perez",
+                                             "Sanchez", "Ramirez", "Torres", "Florez", "Rivera", "Gomez", "Diaz",
+                                             "Moreno", "Jimenez", "Herrera", "Castro", "Vargas", "Rojas", "Suarez" };
+    const char* nombre = NOMBRES[rng() % 20];
+    const char* ap1 = APELLIDOS[rng() % 20];
+    const char* ap2 = APELLIDOS[rng() % 20];
+    Estudiante e;
+    e.identificacion = id;
+    e.nombreCompleto = string(nombre) + " " + ap1 + " " + ap2;
+    e.anoNacimiento = 1990 + rng() % 18;
+    e.promedio = (rng() % 501) / 100.0f;
+    e.email = minusculas(nombre) + "." + minusculas(ap1) + to_string(id) + "@correo.edu";
+    return e;
+}
+
+// Muestras de una ECG sintética (mismo generador que codigo2) en vectores
+void ecgSintetica(double hz, double minutos, vector<double>& t, vector<double>& a) {
+    SenalECG s;
+    generarECGSintetica(s, minutos * 60, hz);
+    s.copiarMuestras(t, a);
+}
+
+// ---------- Casos ----------
+
+void casosListado(Banco& b, size_t n) {
+    string config = "listado/n=" + to_string(n);
+    if (!b.activa(config)) return;
+    mt19937 rng(2025);
+    vector<Estudiante> datos(n);
+    for (size_t i = 0; i < n; ++i) datos[i] = estudianteSintetico(rng, (int)i + 1);
+
+    ListadoEstudiantil lista;
+    b.medir(config + "/insertar", n, [&](size_t i) { lista.insertar(datos[i]); });
+
+    const size_t Q = 1000;
+    vector<string> prefijos(Q), subcadenas(Q), cortas(Q);
+    vector<int> anos(Q);
+    for (size_t q = 0; q < Q; ++q) {
+        const Estudiante& e = datos[rng() % n];
+        size_t sep = e.nombreCompleto.find(' ');
+        prefijos[q] = e.nombreCompleto.substr(0, sep + 4);   // nombre + inicio del primer apellido
+        size_t p = rng() % (e.email.size() - 4);
+        subcadenas[q] = e.email.substr(p, 4);
+        cortas[q] = e.email.substr(p, 1 + q % 2);   // 1 y 2 caracteres
+        anos[q] = 1990 + rng() % 18;
+    }
+    size_t encontrados = 0;
+    b.medir(config + "/buscar_prefijo", Q, [&](size_t q) {
+        encontrados += lista.buscarPrefijo(prefijos[q], CAMPO_NOMBRE).size();
+    });
+    b.medir(config + "/buscar_subcadena", Q, [&](size_t q) {
+        encontrados += lista.buscarSubcadena(subcadenas[q], CAMPO_EMAIL).size();
+    });
+    b.medir(config + "/buscar_subcadena_corta", Q, [&](size_t q) {
+        encontrados += lista.buscarSubcadena(cortas[q], CAMPO_EMAIL).size();
+    });
+    b.medir(config + "/resumen_ano", Q, [&](size_t q) {
+        encontrados += lista.resumenPromediosAno(anos[q]).cantidad;
+    });
+    // buscar y eliminar por id recorren la lista: pocas operaciones, con ids distintos para que
+    // todas las eliminaciones encuentren al estudiante (prefijo barajado de 1..n)
+    const size_t L = min<size_t>(100, n);
+    vector<int> ids(n);
+    iota(ids.begin(), ids.end(), 1);
+    for (size_t i = 0; i < L; ++i) swap(ids[i], ids[i + rng() % (n - i)]);
+    b.medir(config + "/buscar_id", L, [&](size_t q) { encontrados += lista.buscar(ids[q]) > 0; });
+    b.medir(config + "/eliminar", L, [&](size_t q) { encontrados += lista.eliminar(ids[q]); });
+    g_sumidero = encontrados;
+}
+
+void casosECG(Banco& b, double hz, double minutos) {
+    ostringstream cfg;
+    cfg << "ecg/" << hz << "hz/" << minutos << "min";
+    string config = cfg.str();
+    if (!b.activa(config)) return;
+    vector<double> t, a;
+    ecgSintetica(hz, minutos, t, a);
+    const size_t n = t.size();
+
+    SenalECG s;
+    b.medir(config + "/insertar", n, [&](size_t i) { s.insertar(t[i], a[i]); });
+    // las pasadas completas se repiten pocas veces; invalidarCache obliga a recalcular
+    const int P = 5;
+    b.medir(config + "/filtro_iir", P, [&](size_t) { s.invalidarCache(); s.filtroIIR(0.9); });
+    b.medir(config + "/filtro_fir", P, [&](size_t) { s.invalidarCache(); s.filtroFIR_movingAverage(51); });
+    size_t picos = 0;
+    // sobre la señal ya filtrada: recalcula nivel y picos
+    b.medir(config + "/picos", P, [&](size_t) { s.invalidarCache(); picos += s.detectarPicos(0.5, 0.25).size(); });
+    b.medir(config + "/picos_cache", 1000, [&](size_t) { picos += s.detectarPicos(0.5, 0.25).size(); });
+    // barrido de 25 combinaciones de umbral y refractario desde cero: nivel una vez, picos 25 veces
+    b.medir(config + "/ritmo_barrido", P, [&](size_t) {
+        s.invalidarCache();
+        for (int k = 0; k < 25; ++k) picos += s.resumenRitmo(0.4 + 0.05 * (k % 5), 0.2 + 0.02 * (k / 5)).latidos;
+    });
+
+    const string tmp = "benchmark_tmp.ecgz";
+    b.medir(config + "/guardar_ecgz", 3, [&](size_t) { s.guardarComprimido(tmp); });
+    b.medir(config + "/cargar_ecgz", 3, [&](size_t) { SenalECG c; c.cargarComprimido(tmp); picos += c.size(); });
+    remove(tmp.c_str());
+    g_sumidero = picos;
+}
+
+template <class R>
+void casosDomino(Banco& b, const string& variante, int jugadores, int rondas) {
+    string config = "domino/" + variante;
+    if (!b.activa(config)) return;
+    JuegoDomino<R> game;
+    game.setupPlayersAuto(jugadores);
+    game.seed(12345);
+    int ganadas = 0;
+    b.medir(config + "/ronda", rondas, [&](size_t) { ganadas += game.simulateRound() == 0; });
+
+    // finales de 12 fichas repartidas en orden, con extremos al azar (como --resolver-finales)
+    typedef typename R::Mascara Mascara;
+    const int F = 200, FICHAS = 12;
+    mt19937 rng(2025);
+    vector<Mascara> manos(F * R::MAX_JUGADORES, Mascara());
+    vector<int> izq(F), der(F);
+    for (int f = 0; f < F; ++f) {
+        int ids[R::NUM_FICHAS];
+        for (int id = 0; id < R::NUM_FICHAS; ++id) ids[id] = id;
+        shuffle(ids, ids + R::NUM_FICHAS, rng);
+        for (int k = 0; k < FICHAS; ++k) manos[f * R::MAX_JUGADORES + k % jugadores] |= R::bit(ids[k]);
+        uniform_int_distribution<int> pip(0, R::MAX_PIP);
+        izq[f] = pip(rng);
+        der[f] = pip(rng);
+    }
+    b.medir(config + "/final_12_fichas", F, [&](size_t f) {
+        SolverFinal<R> solver;
+        ganadas += solver.resolver(&manos[f * R::MAX_JUGADORES], jugadores, izq[f], der[f], 0).ganador == 0;
+    });
+    g_sumidero = ganadas;
+}
+
+// ---------- Comparación con la base ----------
+
+// Lee un número que sigue a "clave": en una línea del JSON
+bool leerCampo(const string& linea, const string& clave, double& v) {
+    size_t p = linea.find("\"" + clave + "\": ");
+    if (p == string::npos) return false;
+    v = atof(linea.c_str() + p + clave.size() + 4);
+    return true;
+}
+
+// Compara ops/s, mediana y reservas por operación con la base; devuelve cuántos casos empeoraron,
+// o -1 si la base no se pudo leer o no se comparó ningún caso
+int comparar(const Banco& b, const string& archivo, double tolerancia, const string& solo) {
+    ifstream in(archivo);
+    if (!in.is_open()) { cout << "No se pudo abrir la base " << archivo << "\n"; return -1; }
+    struct Base { double opsSeg, p50, reservasOp; };
+    map<string, Base> base;
+    string linea;
+    while (getline(in, linea)) {
+        size_t p = linea.find("\"nombre\": \"");
+        if (p == string::npos) continue;
+        p += 11;
+        string nombre = linea.substr(p, linea.find('"', p) - p);
+        Base v = { 0, 0, 0 };
+        leerCampo(linea, "ops_s", v.opsSeg);
+        leerCampo(linea, "p50_us", v.p50);
+        leerCampo(linea, "reservas_op", v.reservasOp);
+        base[nombre] = v;
+    }
+
+    int peores = 0, comparados = 0;
+    set<string> medidos;
+    cout << "\nComparación con " << archivo << " (tolerancia " << tolerancia << "%):\n";
+    for (const Resultado& r : b.todos()) {
+        medidos.insert(r.nombre);
+        auto it = base.find(r.nombre);
+        if (it == base.end()) { cout << "  " << r.nombre << ": nuevo\n"; continue; }
+        ++comparados;
+        // más lento solo si empeoran el total y la mediana: una pausa aislada del sistema no cuenta
+        const Base& v = it->second;
+        double razon = v.opsSeg > 0 ? r.opsSeg() / v.opsSeg : 1;
+        double razonP50 = r.p50 > 0 ? v.p50 / r.p50 : 1;
+        bool lento = razon < 1 - tolerancia / 100 && razonP50 < 1 - tolerancia / 100;
+        bool reserva = r.reservasOp > v.reservasOp * 1.01 + 0.01;
+        cout << "  " << left << setw(44) << r.nombre << right << fixed << setprecision(2) << setw(8) << razon
+             << "x" << defaultfloat << setprecision(6);
+        if (lento) cout << "  MÁS LENTO";
+        if (reserva) cout << "  MÁS RESERVAS (" << v.reservasOp << " -> " << r.reservasOp << " por op)";
+        cout << "\n";
+        if (lento || reserva) ++peores;
+    }
+    // casos de la base que esta corrida no midió; los que quedan fuera de --solo solo se cuentan
+    int fueraDeSolo = 0;
+    for (const auto& kv : base) {
+        if (medidos.count(kv.first)) continue;
+        if (!solo.empty() && kv.first.find(solo) == string::npos) ++fueraDeSolo;
+        else cout << "  " << kv.first << ": sin medir\n";
+    }
+    if (fueraDeSolo) cout << "  (" << fueraDeSolo << " caso(s) de la base fuera de --solo)\n";
+    if (comparados == 0) { cout << "Ningún caso comparado.\n"; return -1; }
+    cout << (peores ? to_string(peores) + " caso(s) empeoraron.\n" : string("Sin regresiones.\n"));
+    return peores;
+}
+
+// ---------- Línea de comandos ----------
+
+vector<double> listaNumeros(const string& s) {
+    vector<double> v;
+    stringstream ss(s);
+    string x;
+    while (getline(ss, x, ',')) if (atof(x.c_str()) > 0) v.push_back(atof(x.c_str()));
+    return v;
+}
+
+void ayuda() {
+    cout << "Uso: benchmark.exe [opciones]\n"
+            "  --rapido                 tamaños pequeños (prueba rápida)\n"
+            "  --estudiantes a,b,...    tamaños del listado (por defecto 1e3,1e4,1e5; admite hasta 1e7)\n"
+            "  --ecg-hz a,b,...         frecuencias de muestreo (por defecto 250,500,1000)\n"
+            "  --ecg-minutos a,b,...    duraciones de la señal (por defecto 1,10)\n"
+            "  --rondas n               rondas de dominó por variante (por defecto 20000)\n"
+            "  --solo texto             solo las configuraciones que contienen el texto (p. ej. listado/n=100000)\n"
+            "  --salida archivo.json    dónde guardar los resultados (por defecto benchmark_resultados.json)\n"
+            "  --comparar base.json     compara con una corrida anterior; termina con 1 si hay regresiones\n"
+            "                           o si no se comparó ningún caso\n"
+            "  --tolerancia pct         caída aceptada al comparar (por defecto 15); un caso es más lento solo\n"
+            "                           si caen más que eso tanto las ops/s totales como la mediana\n";
+}
+
+int main(int argc, char** argv) {
+    Opciones opc;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (a == "--rapido") {
+            opc.estudiantes = { 1e3, 1e4 };
+            opc.ecgHz = { 250 };
+            opc.ecgMinutos = { 1 };
+            opc.rondas = 2000;
+        } else if (a == "--estudiantes" && hayValor) opc.estudiantes = listaNumeros(argv[++i]);
+        else if (a == "--ecg-hz" && hayValor) opc.ecgHz = listaNumeros(argv[++i]);
+        else if (a == "--ecg-minutos" && hayValor) opc.ecgMinutos = listaNumeros(argv[++i]);
+        else if (a == "--rondas" && hayValor) opc.rondas = max(1, atoi(argv[++i]));
+        else if (a == "--solo" && hayValor) opc.solo = argv[++i];
+        else if (a == "--salida" && hayValor) opc.salida = argv[++i];
+        else if (a == "--comparar" && hayValor) opc.base = argv[++i];
+        else if (a == "--tolerancia" && hayValor) opc.tolerancia = atof(argv[++i]);
+        else { ayuda(); return a == "--ayuda" ? 0 : 1; }
+    }
+
+    Banco b(opc);
+    Banco::encabezado();
+    for (double n : opc.estudiantes) casosListado(b, (size_t)n);
+    for (double hz : opc.ecgHz)
+        for (double m : opc.ecgMinutos) casosECG(b, hz, m);
+    casosDomino<DobleSeis>(b, "doble_seis", 4, opc.rondas);
+    casosDomino<DobleSeisParejas>(b, "doble_seis_parejas", 4, opc.rondas);
+    casosDomino<DobleSeisRobo>(b, "doble_seis_robo", 2, opc.rondas);
+    casosDomino<DobleNueve>(b, "doble_nueve", 5, opc.rondas);
+    casosDomino<DobleDoce>(b, "doble_doce", 7, opc.rondas);
+    casosDomino<DobleQuince>(b, "doble_quince", 8, opc.rondas);
+
+    if (b.guardarJSON(opc.salida)) cout << "Resultados guardados en '" << opc.salida << "'\n";
+    else cout << "No se pudo escribir " << opc.salida << "\n";
+    if (!opc.base.empty()) return comparar(b, opc.base, opc.tolerancia, opc.solo) == 0 ? 0 : 1;
+    return 0;
+}
@@ -1,176 +1,212 @@
-#include <iostream>
-#include <fstream>
-#include <string>
-using namespace std;
-
-// Estructura para guardar los datos del estudiante
-struct Estudiante {
-    string nombreCompleto;
-    int anoNacimiento;
-    int identificacion;
-    float promedio;
-    string email;
-};
-
-// Nodo de la lista enlazada simple
-struct Nodo {
-    Estudiante dato;
-    Nodo* siguiente;
-
-    Nodo(const Estudiante& est) : dato(est), siguiente(nullptr) {}
-};
-
-class ListadoEstudiantil {
-private:
-    Nodo* cabeza;
-    int tamano;
-
-public:
-    // Lista vacía al inicio
-    ListadoEstudiantil() : cabeza(nullptr), tamano(0) {}
-
-    // Insertar al final
-    void insertar(const Estudiante& est) {
-        Nodo* nuevo = new Nodo(est);
-
-        if (!cabeza) {
-            cabeza = nuevo;
-        } else {
-            Nodo* temp = cabeza;
-            while (temp->siguiente)
-                temp = temp->siguiente;
-            temp->siguiente = nuevo;
-        }
-        tamano++;
-    }
+#include "listado_estudiantil.h"
 
-    // Buscar estudiante por ID
-    int buscar(int id) {
-        Nodo* temp = cabeza;
-        int pos = 1;
+// Menu simple
+void mostrarMenu() {
+    cout << "\n===== MENU LISTADO ESTUDIANTIL =====\n";
+    cout << "1. Insertar estudiante\n";
+    cout << "2. Buscar estudiante\n";
+    cout << "3. Eliminar estudiante\n";
+    cout << "4. Imprimir lista en archivo TXT\n";
+    cout << "5. Invertir lista\n";
+    cout << "6. Mostrar estudiante por indice\n";
+    cout << "7. Buscar por nombre o email\n";
+    cout << "8. Estadisticas de promedios\n";
+    cout << "9. Salir\n";
+    cout << "Seleccione opcion: ";
+}
 
-        while (temp) {
-            if (temp->dato.identificacion == id)
-                return pos;
-            temp = temp->siguiente;
-            pos++;
+// Aplica n mutaciones al azar (70% insertar, 20% eliminar, 10% invertir) con la misma semilla
+void mutacionesAzar(ListadoEstudiantil& lista, int n, unsigned semilla) {
+    mt19937 rng(semilla);
+    int siguienteId = 1;
+    for (int i = 0; i < n; ++i) {
+        int r = rng() % 10;
+        if (r < 7) {
+            Estudiante e;
+            e.identificacion = siguienteId++;
+            e.nombreCompleto = "Estudiante " + to_string(e.identificacion);
+            e.anoNacimiento = 1990 + rng() % 15;
+            e.promedio = (rng() % 501) / 100.0f;
+            e.email = "e" + to_string(e.identificacion) + "@correo.edu";
+            lista.insertar(e);
+        } else if (r < 9) {
+            lista.eliminar(1 + rng() % siguienteId);
+        } else {
+            lista.invertir();
         }
-        return -1;
     }
+}
 
-    // Eliminar estudiante por ID
-    bool eliminar(int id) {
-        if (!cabeza) return false;
-
-        // Eliminación de la cabeza
-        if (cabeza->dato.identificacion == id) {
-            Nodo* aux = cabeza;
-            cabeza = cabeza->siguiente;
-            delete aux;
-            tamano--;
-            return true;
-        }
-
-        // Buscar nodo anterior
-        Nodo* temp = cabeza;
-        while (temp->siguiente &&
-               temp->siguiente->dato.identificacion != id)
-        {
-            temp = temp->siguiente;
-        }
-
-        if (!temp->siguiente) return false;
+bool mismoContenido(const vector<Estudiante>& a, const vector<Estudiante>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].nombreCompleto != b[i].nombreCompleto || a[i].anoNacimiento != b[i].anoNacimiento ||
+            a[i].identificacion != b[i].identificacion || a[i].promedio != b[i].promedio || a[i].email != b[i].email)
+            return false;
+    return true;
+}
 
-        Nodo* eliminar = temp->siguiente;
-        temp->siguiente = eliminar->siguiente;
-        delete eliminar;
-        tamano--;
-        return true;
+// Comprueba el diario: mutaciones al azar, recuperación (con compactaciones de por medio)
+// y recuperación tras una escritura cortada a la mitad. Usa la carpeta "prueba_diario"
+int verificarDiario(int n) {
+    const string carpeta = "prueba_diario";
+    error_code ec;
+    filesystem::remove_all(carpeta, ec);
+    filesystem::create_directory(carpeta, ec);
+    const string prefijo = carpeta + "/estudiantes";
+    // archivo ajeno con el mismo prefijo (como el que deja la opción 4): no debe borrarse
+    ofstream(prefijo + ".txt") << "ajeno\n";
+
+    ListadoEstudiantil esperado;
+    mutacionesAzar(esperado, n, 7);
+    bool ok = true;
+    {
+        ListadoEstudiantil lista;
+        DiarioEstudiantil diario(prefijo);
+        size_t rec;
+        diario.abrir(lista, rec);
+        lista.adjuntarDiario(&diario);
+        auto t0 = chrono::steady_clock::now();
+        mutacionesAzar(lista, n, 7);
+        lista.sincronizar();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << n << " mutaciones en " << ms << " ms: " << diario.numLotes() << " lotes, "
+             << diario.numFsyncs() << " fsync, generación " << diario.numGeneracion() << "\n";
     }
+    {
+        ListadoEstudiantil lista;
+        DiarioEstudiantil diario(prefijo);
+        size_t rec;
+        auto t0 = chrono::steady_clock::now();
+        ok = diario.abrir(lista, rec) && mismoContenido(lista.copia(), esperado.copia());
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "Recuperación: " << lista.size() << " estudiantes, " << rec << " registros del diario, "
+             << ms << " ms: " << (ok ? "OK" : "DIFERENTE") << "\n";
+    }
+    // simula una caída a mitad de escritura: registro incompleto al final del diario
+    {
+        ListadoEstudiantil lista;
+        DiarioEstudiantil diario(prefijo);
+        size_t rec;
+        diario.abrir(lista, rec);
+        uint64_t g = diario.numGeneracion();
+        diario.cerrar();
+        ofstream cola(prefijo + "." + to_string(g) + ".wal", ios::binary | ios::app);
+        cola.write("\x01\x40\x00\x00\x00parcial", 12);
+    }
+    {
+        ListadoEstudiantil lista;
+        DiarioEstudiantil diario(prefijo);
+        size_t rec;
+        bool ok2 = diario.abrir(lista, rec) && mismoContenido(lista.copia(), esperado.copia());
+        cout << "Recuperación con registro cortado: " << (ok2 ? "OK" : "DIFERENTE") << "\n";
+        ok = ok && ok2;
+    }
+    bool ajeno = filesystem::exists(prefijo + ".txt");
+    cout << "Archivo ajeno al diario: " << (ajeno ? "intacto" : "BORRADO") << "\n";
+    ok = ok && ajeno;
+    filesystem::remove_all(carpeta, ec);
+    return ok ? 0 : 1;
+}
 
-    // Acceso por índice
-    Estudiante operator[](int index) {
-        if (index < 0 || index >= tamano) {
-            throw out_of_range("Índice fuera de rango");
-        }
-
-        Nodo* temp = cabeza;
-        for (int i = 0; i < index; i++)
-            temp = temp->siguiente;
-
-        return temp->dato;
+// Recalcula un resumen recorriendo los valores (referencia para --verificar-agregados)
+ResumenPromedio resumenDirecto(vector<float> v) {
+    ResumenPromedio r;
+    r.cantidad = (int)v.size();
+    double suma = 0;
+    for (float x : v) suma += x;
+    r.media = r.cantidad ? suma / r.cantidad : 0.0;
+    r.minimo = r.maximo = r.mediana = 0;
+    sort(v.begin(), v.end());
+    if (r.cantidad) {
+        r.minimo = v.front();
+        r.maximo = v.back();
+        int k = r.cantidad / 2;
+        r.mediana = v[k];
+        if (r.cantidad % 2 == 0) r.mediana = (r.mediana + v[k - 1]) / 2;
+    }
+    for (int c = 0; c < ResumenPromedio::CUBETAS; ++c) r.histograma[c] = 0;
+    for (float x : v) {
+        int c = (int)(x / 0.5f);
+        r.histograma[max(0, min(c, ResumenPromedio::CUBETAS - 1))]++;
     }
+    return r;
+}
 
-    // Imprimir lista completa en archivo TXT
-    void imprimirTXT() {
-        ofstream archivo("estudiantes.txt");
+bool mismoResumen(const ResumenPromedio& a, const ResumenPromedio& b) {
+    if (a.cantidad != b.cantidad || a.minimo != b.minimo || a.maximo != b.maximo || a.mediana != b.mediana) return false;
+    if (a.media - b.media > 1e-9 || b.media - a.media > 1e-9) return false;
+    for (int c = 0; c < ResumenPromedio::CUBETAS; ++c) if (a.histograma[c] != b.histograma[c]) return false;
+    return true;
+}
 
-        if (!archivo.is_open()) {
-            cout << "Error al crear archivo.\n";
-            return;
+// Prueba aleatoria de los agregados: tras cada mutación compara contra un recálculo completo
+int verificarAgregados(int n) {
+    mt19937 rng(11);
+    ListadoEstudiantil lista;
+    vector<int> ids;
+    int siguienteId = 1;
+    for (int paso = 0; paso < n; ++paso) {
+        int r = rng() % 10;
+        if (r < 6 || ids.empty()) {
+            Estudiante e;
+            e.identificacion = siguienteId++;
+            e.nombreCompleto = "Estudiante " + to_string(e.identificacion);
+            e.anoNacimiento = 1995 + rng() % 8;
+            e.promedio = (rng() % 51) / 10.0f;   // valores repetidos a propósito
+            e.email = "e" + to_string(e.identificacion) + "@correo.edu";
+            lista.insertar(e);
+            ids.push_back(e.identificacion);
+        } else if (r < 9) {
+            size_t k = rng() % ids.size();
+            lista.eliminar(ids[k]);
+            ids[k] = ids.back();
+            ids.pop_back();
+        } else {
+            lista.invertir();
         }
 
-        Nodo* temp = cabeza;
-        archivo << "===== LISTADO DE ESTUDIANTES =====\n\n";
-
-        while (temp) {
-            archivo << "Nombre: " << temp->dato.nombreCompleto << "\n";
-            archivo << "Año nacimiento: " << temp->dato.anoNacimiento << "\n";
-            archivo << "ID: " << temp->dato.identificacion << "\n";
-            archivo << "Promedio: " << temp->dato.promedio << "\n";
-            archivo << "Email: " << temp->dato.email << "\n";
-            archivo << "----------------------------------\n";
-            temp = temp->siguiente;
+        vector<float> todos;
+        map<int, vector<float>> grupos;
+        for (const auto& e : lista.copia()) {
+            todos.push_back(e.promedio);
+            grupos[e.anoNacimiento].push_back(e.promedio);
         }
-
-        archivo.close();
-        cout << "Archivo 'estudiantes.txt' generado correctamente.\n";
-    }
-
-    // Invertir la lista
-    void invertir() {
-        Nodo* prev = nullptr;
-        Nodo* actual = cabeza;
-        Nodo* siguiente = nullptr;
-
-        while (actual) {
-            siguiente = actual->siguiente;
-            actual->siguiente = prev;
-            prev = actual;
-            actual = siguiente;
+        bool ok = mismoResumen(lista.resumenPromedios(), resumenDirecto(todos));
+        vector<pair<int, ResumenPromedio>> porAno = lista.resumenPromediosPorAno();
+        ok = ok && porAno.size() == grupos.size();
+        for (size_t i = 0; ok && i < porAno.size(); ++i) {
+            auto it = grupos.find(porAno[i].first);
+            ok = it != grupos.end() && mismoResumen(porAno[i].second, resumenDirecto(it->second)) &&
+                 mismoResumen(lista.resumenPromediosAno(porAno[i].first), porAno[i].second);
         }
-
-        cabeza = prev;
-    }
-
-    // Liberar memoria
-    ~ListadoEstudiantil() {
-        Nodo* temp;
-        while (cabeza) {
-            temp = cabeza;
-            cabeza = cabeza->siguiente;
-            delete temp;
+        ok = ok && lista.resumenPromediosAno(1900).cantidad == 0;
+        if (!ok) {
+            cout << "Agregados distintos del recálculo en el paso " << paso << ".\n";
+            return 1;
         }
     }
-
-    int size() { return tamano; }
-};
-
-// Menu simple
-void mostrarMenu() {
-    cout << "\n===== MENU LISTADO ESTUDIANTIL =====\n";
-    cout << "1. Insertar estudiante\n";
-    cout << "2. Buscar estudiante\n";
-    cout << "3. Eliminar estudiante\n";
-    cout << "4. Imprimir lista en archivo TXT\n";
-    cout << "5. Invertir lista\n";
-    cout << "6. Mostrar estudiante por indice\n";
-    cout << "7. Salir\n";
-    cout << "Seleccione opcion: ";
+    cout << n << " mutaciones verificadas: " << lista.size() << " estudiantes, "
+         << lista.resumenPromediosPorAno().size() << " años. OK\n";
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--verificar-diario")
+        return verificarDiario(argc > 2 ? atoi(argv[2]) : 20000);
+    if (argc > 1 && string(argv[1]) == "--verificar-agregados")
+        return verificarAgregados(argc > 2 ? atoi(argv[2]) : 5000);
+
     ListadoEstudiantil lista;
+    DiarioEstudiantil diario;
+    size_t recuperados;
+    if (!diario.abrir(lista, recuperados)) {
+        cout << "Error al abrir el diario de estudiantes.\n";
+        return 1;
+    }
+    if (lista.size() > 0 || recuperados > 0)
+        cout << "Recuperados " << lista.size() << " estudiantes (" << recuperados << " cambios del diario).\n";
+    lista.adjuntarDiario(&diario);
     int opcion;
 
     do {
@@ -196,6 +232,7 @@ int main() {
             cin >> est.email;
 
             lista.insertar(est);
+            lista.sincronizar();
             cout << "Estudiante agregado correctamente.\n";
         }
 
@@ -216,8 +253,10 @@ int main() {
             cout << "Ingrese ID a eliminar: ";
             cin >> id;
 
-            if (lista.eliminar(id))
+            if (lista.eliminar(id)) {
+                lista.sincronizar();
                 cout << "Eliminado correctamente.\n";
+            }
             else
                 cout << "No se encontró ese ID.\n";
         }
@@ -228,6 +267,7 @@ int main() {
 
         else if (opcion == 5) {
             lista.invertir();
+            lista.sincronizar();
             cout << "Lista invertida correctamente.\n";
         }
 
@@ -249,7 +289,45 @@ int main() {
             }
         }
 
-    } while (opcion != 7);
+        else if (opcion == 7) {
+            int campo, tipo;
+            string texto;
+            cout << "Campo (1 = nombre, 2 = email): ";
+            cin >> campo;
+            cout << "Tipo (1 = empieza con, 2 = contiene): ";
+            cin >> tipo;
+            cout << "Texto a buscar: ";
+            cin.ignore();
+            getline(cin, texto);
+
+            CampoTexto c = (campo == 2) ? CAMPO_EMAIL : CAMPO_NOMBRE;
+            vector<Estudiante> res = (tipo == 2) ? lista.buscarSubcadena(texto, c)
+                                                 : lista.buscarPrefijo(texto, c);
+            if (res.empty())
+                cout << "No se encontraron estudiantes.\n";
+            for (const auto& e : res)
+                cout << "ID " << e.identificacion << " | " << e.nombreCompleto << " | " << e.email << endl;
+        }
+
+        else if (opcion == 8) {
+            auto mostrar = [](const string& titulo, const ResumenPromedio& r) {
+                cout << titulo << ": " << r.cantidad << " estudiantes";
+                if (r.cantidad)
+                    cout << ", media " << r.media << ", min " << r.minimo << ", max " << r.maximo
+                         << ", mediana " << r.mediana;
+                cout << endl;
+            };
+            ResumenPromedio total = lista.resumenPromedios();
+            mostrar("Total", total);
+            for (const auto& g : lista.resumenPromediosPorAno())
+                mostrar("  Nacidos en " + to_string(g.first), g.second);
+            cout << "Histograma (todos):\n";
+            for (int c = 0; c < ResumenPromedio::CUBETAS; ++c)
+                cout << "  [" << c * 0.5 << ", " << (c + 1) * 0.5 << (c + 1 == ResumenPromedio::CUBETAS ? "]" : ")")
+                     << ": " << total.histograma[c] << endl;
+        }
+
+    } while (opcion != 9);
 
     return 0;
 }
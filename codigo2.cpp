@@ -1,218 +1,185 @@
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <string>
-#include <cmath>
-#include <limits>
-#include <algorithm>
+#include "senal_ecg.h"
 
-using namespace std;
-
-// Nodo de la lista doble: guarda tiempo, amplitud y valor filtrado
-struct Nodo {
-    double tiempo;
-    double amplitud;
-    double filtrada;
-    Nodo* sig;
-    Nodo* ant;
-
-    Nodo(double t = 0.0, double a = 0.0)
-        : tiempo(t), amplitud(a), filtrada(0.0), sig(nullptr), ant(nullptr) {}
-};
-
-// Clase que maneja la señal ECG usando lista doble enlazada
-class SenalECG {
-private:
-    Nodo* inicio;
-    Nodo* fin;
-    size_t tam;
-
-public:
-    // Lista vacía
-    SenalECG() : inicio(nullptr), fin(nullptr), tam(0) {}
-
-    // Liberamos memoria al terminar
-    ~SenalECG() {
-        Nodo* cur = inicio;
-        while (cur) {
-            Nodo* tmp = cur;
-            cur = cur->sig;
-            delete tmp;
-        }
-    }
-
-    // Insertar muestra al final
-    void insertar(double t, double a) {
-        Nodo* n = new Nodo(t, a);
-        if (!inicio) {
-            inicio = fin = n;
-        } else {
-            fin->sig = n;
-            n->ant = fin;
-            fin = n;
-        }
-        tam++;
-    }
-
-    // Cargar datos desde archivo
-    bool cargarDesdeArchivo(const string& nombreArchivo) {
-        ifstream ifs(nombreArchivo);
-        if (!ifs.is_open()) {
-            cerr << "Error abriendo archivo.\n";
-            return false;
-        }
-
-        double t, a;
-        size_t cont = 0;
-
-        while (ifs >> t >> a) {
-            insertar(t, a);
-            cont++;
-        }
-        ifs.close();
-
-        if (cont == 0) {
-            cerr << "Archivo vacío.\n";
-            return false;
+// Compara el procesamiento en serie y en paralelo sobre una señal sintética larga.
+// Prueba varias particiones (aunque haya menos núcleos) y un refractario mayor que el intervalo RR
+int verificarParalelo(double minutos) {
+    SenalECG s;
+    generarECGSintetica(s, minutos * 60);
+    cout << "Señal sintética: " << s.size() << " muestras (" << minutos << " min a 250 Hz)\n";
+
+    auto medir = [&](unsigned hilos, double refractario, vector<double>& filtrada, vector<double>& picos) {
+        s.usarHilos(hilos);
+        s.invalidarCache();
+        auto t0 = chrono::steady_clock::now();
+        s.filtroFIR_movingAverage(51);
+        picos = s.detectarPicos(0.5, refractario);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        filtrada = s.valoresFiltrados();
+        return ms;
+    };
+    auto iguales = [](const vector<double>& a, const vector<double>& b) {
+        return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+    };
+
+    bool ok = true;
+    double tSerie = 0, tPar = 0;
+    const double refractarios[] = { 0.25, 1.3 };
+    const unsigned particiones[] = { 0, 2, 3, 8 };
+    for (double r : refractarios) {
+        vector<double> fSerie, pSerie;
+        double t = medir(1, r, fSerie, pSerie);
+        if (r == refractarios[0]) tSerie = t;
+        for (unsigned h : particiones) {
+            vector<double> f, p;
+            t = medir(h, r, f, p);
+            if (h == 0 && r == refractarios[0]) tPar = t;
+            if (!iguales(f, fSerie) || !iguales(p, pSerie)) {
+                cout << "ERROR: difiere con " << h << " hilos y refractario " << r << "\n";
+                ok = false;
+            }
         }
-
-        cout << "Leídas " << cont << " muestras.\n";
-        return true;
     }
+    cout << "Serie: " << tSerie << " ms, paralelo (" << poolGlobal().tamano() << " hilos): " << tPar
+         << " ms, aceleración " << tSerie / tPar << "x\n";
+    if (ok) cout << "Resultados idénticos bit a bit.\n";
+    return ok ? 0 : 1;
+}
 
-    size_t size() const { return tam; }
-
-    // Filtro IIR simple
-    void filtroIIR(double alpha = 0.98) {
-        if (!inicio) return;
-        if (alpha < 0) alpha = 0;
-        if (alpha > 1) alpha = 1;
-
-        inicio->filtrada = inicio->amplitud;
-        double y_prev = inicio->filtrada;
-
-        Nodo* cur = inicio->sig;
-        while (cur) {
-            cur->filtrada = alpha * y_prev + (1 - alpha) * cur->amplitud;
-            y_prev = cur->filtrada;
-            cur = cur->sig;
-        }
-        cout << "Filtro IIR aplicado.\n";
+// Comprueba el formato .ecgz: ida y vuelta exacta desde texto con 3 decimales, lecturas
+// de rangos al azar con el índice, bloques dañados detectados sin afectar a los demás
+int verificarCompresion(double minutos) {
+    const string texto = "prueba_ecg.txt", comprimido = "prueba_ecg.ecgz";
+    {
+        SenalECG g;
+        generarECGSintetica(g, minutos * 60);
+        vector<double> t, a;
+        g.copiarMuestras(t, a);
+        ofstream ofs(texto);
+        ofs << fixed << setprecision(3);
+        for (size_t i = 0; i < t.size(); i++) ofs << t[i] << " " << a[i] << "\n";
     }
-
-    // Filtro FIR (promedio móvil)
-    void filtroFIR_movingAverage(int ventanaLong = 51) {
-        if (!inicio) return;
-
-        vector<double> buffer;
-        buffer.reserve(tam);
-        for (Nodo* p = inicio; p; p = p->sig) buffer.push_back(p->amplitud);
-
-        int N = ventanaLong;
-        int radio = N / 2;
-        int L = 2 * radio + 1;
-        if (L <= 0) L = 1;
-
-        vector<double> salida(buffer.size(), 0.0);
-
-        for (int i = 0; i < (int)buffer.size(); i++) {
-            double suma = 0;
-            int cuenta = 0;
-            int ini = max(0, i - radio);
-            int fin = min((int)buffer.size() - 1, i + radio);
-
-            for (int k = ini; k <= fin; k++) {
-                suma += buffer[k];
-                cuenta++;
-            }
-
-            salida[i] = (cuenta > 0 ? suma / cuenta : buffer[i]);
-        }
-
-        int idx = 0;
-        for (Nodo* p = inicio; p; p = p->sig, idx++) {
-            p->filtrada = salida[idx];
-        }
-
-        cout << "Filtro FIR aplicado.\n";
+    SenalECG original, recuperada;
+    original.cargarDesdeArchivo(texto);
+    auto t0 = chrono::steady_clock::now();
+    original.guardarComprimido(comprimido);
+    double msCodificar = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    recuperada.cargarDesdeArchivo(comprimido);
+
+    vector<double> to, ao, tr, ar;
+    original.copiarMuestras(to, ao);
+    recuperada.copiarMuestras(tr, ar);
+    // comparación por valor: un "-0.000" del texto vuelve como 0
+    bool ok = to.size() == tr.size() && equal(to.begin(), to.end(), tr.begin()) &&
+              equal(ao.begin(), ao.end(), ar.begin());
+    cout << (ok ? "Ida y vuelta exacta.\n" : "ERROR: las muestras recuperadas difieren.\n");
+
+    ifstream ft(texto, ios::binary | ios::ate), fc(comprimido, ios::binary | ios::ate);
+    double bytesTexto = (double)ft.tellg(), bytesComp = (double)fc.tellg(), bytesBinario = 16.0 * to.size();
+    cout << "Texto: " << bytesTexto << " bytes, binario (2 double): " << bytesBinario << " bytes, ecgz: "
+         << bytesComp << " bytes (" << bytesTexto / bytesComp << "x menos que texto, "
+         << bytesBinario / bytesComp << "x menos que binario)\n";
+
+    // velocidad del decodificador: lectura completa a buffers, sin armar la lista
+    ArchivoECG arch;
+    ok = arch.abrir(comprimido) && ok;
+    vector<double> t, a;
+    const int repeticiones = 5;
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < repeticiones; r++) ok = arch.leer(0, arch.numMuestras(), t, a) && ok;
+    double s = chrono::duration<double>(chrono::steady_clock::now() - t0).count() / repeticiones;
+    cout << "Codificar: " << msCodificar << " ms. Decodificar: " << arch.numMuestras() / s / 1e6
+         << " M muestras/s (" << bytesBinario / s / 1e6 << " MB/s de salida, " << bytesComp / s / 1e6
+         << " MB/s leídos del archivo)\n";
+
+    // rangos al azar usando el índice
+    mt19937 rng(5);
+    for (int k = 0; k < 200 && ok; k++) {
+        uint64_t desde = rng() % to.size(), cant = rng() % 20000;
+        ok = arch.leer(desde, cant, t, a) && t.size() == min<uint64_t>(cant, to.size() - desde) &&
+             equal(t.begin(), t.end(), to.begin() + desde) && equal(a.begin(), a.end(), ao.begin() + desde);
     }
-
-    // Detección de picos básicos
-    vector<double> detectarPicos(double umbralMin = 0.5, double refractario_seg = 0.25) {
-        vector<double> tiempos;
-        if (tam < 3) return tiempos;
-
-        double sum2 = 0, maxAbs = 0;
-        size_t n = 0;
-
-        for (Nodo* p = inicio; p; p = p->sig) {
-            double v = fabs(p->filtrada);
-            sum2 += v * v;
-            maxAbs = max(maxAbs, v);
-            n++;
+    uint32_t b = arch.bloqueDeTiempo(to[to.size() / 2]);
+    ok = ok && b * (uint64_t)arch.muestrasPorBloque() <= to.size() / 2 &&
+         to.size() / 2 < (b + 1) * (uint64_t)arch.muestrasPorBloque();
+    cout << (ok ? "Lecturas por rango y búsqueda por tiempo correctas.\n" : "ERROR en lecturas por rango.\n");
+
+    // dañar un byte del segundo bloque: ese bloque falla, el primero se sigue leyendo
+    if (arch.numBloques() > 2) {
+        {
+            fstream f(comprimido, ios::binary | ios::in | ios::out);
+            f.seekp((arch.posicionBloque(1) + arch.posicionBloque(2)) / 2);
+            char c = 0x55;
+            f.write(&c, 1);
         }
-
-        double rms = (n > 0 ? sqrt(sum2 / n) : 0);
-        double umbral = max(umbralMin, rms * 1.2);
-        if (maxAbs > 0 && umbral > 0.9 * maxAbs) umbral = 0.6 * maxAbs;
-
-        Nodo* cur = inicio->sig;
-        double ultimo = -1e9;
-
-        while (cur && cur->sig) {
-            double y = cur->filtrada;
-
-            if (y > cur->ant->filtrada && y > cur->sig->filtrada && fabs(y) >= umbral) {
-                if (cur->tiempo - ultimo >= refractario_seg) {
-                    tiempos.push_back(cur->tiempo);
-                    ultimo = cur->tiempo;
-                }
-            }
-            cur = cur->sig;
-        }
-
-        cout << "Picos detectados: " << tiempos.size() << "\n";
-        return tiempos;
+        ArchivoECG danado;
+        bool primero = danado.abrir(comprimido) && danado.leer(0, arch.muestrasPorBloque(), t, a);
+        bool segundo = danado.leer(arch.muestrasPorBloque(), arch.muestrasPorBloque(), t, a);
+        bool detectado = primero && !segundo;
+        cout << (detectado ? "Bloque dañado detectado; los demás bloques se leen igual.\n"
+                           : "ERROR: no se detectó el bloque dañado.\n");
+        ok = ok && detectado;
     }
+    remove(texto.c_str());
+    remove(comprimido.c_str());
+    return ok ? 0 : 1;
+}
 
-    // Guardar señal procesada
-    bool guardarEnArchivo(const string& nombreSalida) const {
-        ofstream ofs(nombreSalida);
-        if (!ofs.is_open()) {
-            cerr << "Error guardando archivo.\n";
-            return false;
+// Comprueba el grafo de etapas: consultas repetidas sin recálculo, barridos de parámetros que
+// solo recalculan los picos, y resultados iguales a los de una señal sin caché
+int verificarGrafo(double minutos) {
+    SenalECG s, ref;
+    generarECGSintetica(s, minutos * 60);
+    generarECGSintetica(ref, minutos * 60);
+    cout << "Señal sintética: " << s.size() << " muestras\n";
+    bool ok = true;
+    auto ms = [](chrono::steady_clock::time_point t0) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    s.filtroFIR_movingAverage(51);
+    double bpm = s.frecuenciaCardiacaPromedio(0.5, 0.25);
+    double primera = ms(t0);
+    t0 = chrono::steady_clock::now();
+    s.filtroFIR_movingAverage(51);
+    double bpm2 = s.frecuenciaCardiacaPromedio(0.5, 0.25);
+    double repetida = ms(t0);
+    ok = ok && bpm == bpm2 && s.numCalculos(SenalECG::ETAPA_FILTRO) == 1 &&
+         s.numCalculos(SenalECG::ETAPA_NIVEL) == 1 && s.numCalculos(SenalECG::ETAPA_PICOS) == 1 &&
+         s.numCalculos(SenalECG::ETAPA_RITMO) == 1;
+    cout << "Primera consulta: " << primera << " ms, repetida: " << repetida << " ms\n";
+
+    // barrido de umbral y refractario: solo cambian los picos y el ritmo
+    double tCache = 0, tSin = 0;
+    int combinaciones = 0;
+    for (double u = 0.3; u <= 0.71; u += 0.1)
+        for (double r = 0.2; r <= 0.61; r += 0.1) {
+            t0 = chrono::steady_clock::now();
+            ResumenRitmo a = s.resumenRitmo(u, r);
+            tCache += ms(t0);
+            ref.invalidarCache();
+            t0 = chrono::steady_clock::now();
+            ref.filtroFIR_movingAverage(51);
+            ResumenRitmo b = ref.resumenRitmo(u, r);
+            tSin += ms(t0);
+            ok = ok && a.latidos == b.latidos && a.bpm == b.bpm && a.sdnn == b.sdnn && a.rmssd == b.rmssd &&
+                 a.pnn50 == b.pnn50 && s.detectarPicos(u, r) == ref.detectarPicos(u, r);
+            combinaciones++;
         }
-
-        ofs << "tiempo\toriginal\tfiltrada\n";
-        for (Nodo* p = inicio; p; p = p->sig)
-            ofs << p->tiempo << "\t" << p->amplitud << "\t" << p->filtrada << "\n";
-
-        ofs.close();
-        cout << "Archivo guardado.\n";
-        return true;
-    }
-
-    // Calcular frecuencia cardíaca
-    double frecuenciaCardiacaPromedio(double umbralMin = 0.5, double refractario_seg = 0.25) {
-        vector<double> picos = detectarPicos(umbralMin, refractario_seg);
-        if (picos.size() < 2) return 0;
-
-        double sumaRR = 0;
-        for (size_t i = 1; i < picos.size(); i++)
-            sumaRR += (picos[i] - picos[i - 1]);
-
-        double rr_prom = sumaRR / (picos.size() - 1);
-        return (rr_prom > 0 ? 60.0 / rr_prom : 0);
-    }
-
-    // Mostrar algunas muestras
-    void debugPrint(int n = 10) const {
-        cout << "Primeras " << n << " muestras:\n";
-        int i = 0;
-        for (Nodo* p = inicio; p && i < n; p = p->sig, i++)
-            cout << p->tiempo << "\t" << p->amplitud << "\t" << p->filtrada << "\n";
-    }
-};
+    ok = ok && s.numCalculos(SenalECG::ETAPA_FILTRO) == 1 && s.numCalculos(SenalECG::ETAPA_NIVEL) == 1;
+    cout << "Barrido de " << combinaciones << " combinaciones: " << tCache << " ms con caché, " << tSin
+         << " ms recalculando todo; etapa de picos calculada " << s.numCalculos(SenalECG::ETAPA_PICOS)
+         << " veces, nivel " << s.numCalculos(SenalECG::ETAPA_NIVEL) << " vez\n";
+
+    // una muestra nueva invalida todo lo que depende de la señal
+    s.insertar(minutos * 60, 0.0);
+    s.filtroFIR_movingAverage(51);
+    s.detectarPicos(0.5, 0.25);
+    ok = ok && s.numCalculos(SenalECG::ETAPA_FILTRO) == 2 && s.numCalculos(SenalECG::ETAPA_NIVEL) == 2;
+
+    cout << (ok ? "Grafo de etapas correcto.\n" : "ERROR en el grafo de etapas.\n");
+    return ok ? 0 : 1;
+}
 
 // Limpia entrada del usuario
 void limpiarEntrada() {
@@ -234,7 +201,14 @@ void menuPrincipal() {
     cout << "Opción: ";
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--verificar-paralelo")
+        return verificarParalelo(argc > 2 ? atof(argv[2]) : 120);
+    if (argc > 1 && string(argv[1]) == "--verificar-compresion")
+        return verificarCompresion(argc > 2 ? atof(argv[2]) : 120);
+    if (argc > 1 && string(argv[1]) == "--verificar-grafo")
+        return verificarGrafo(argc > 2 ? atof(argv[2]) : 30);
+
     SenalECG s;
     bool cargado = false;
     int opcion = 0;
@@ -290,8 +264,11 @@ int main() {
             if (!(cin >> u)) { limpiarEntrada(); continue; }
             cout << "Refractario: ";
             if (!(cin >> r)) { limpiarEntrada(); continue; }
-            double bpm = s.frecuenciaCardiacaPromedio(u, r);
-            cout << "BPM: " << bpm << "\n";
+            ResumenRitmo rr = s.resumenRitmo(u, r);
+            cout << "BPM: " << rr.bpm << "\n";
+            if (rr.latidos > 2)
+                cout << "HRV: SDNN " << rr.sdnn * 1000 << " ms, RMSSD " << rr.rmssd * 1000
+                     << " ms, pNN50 " << rr.pnn50 << " %\n";
         }
 
         else if (opcion == 6) {
@@ -301,7 +278,10 @@ int main() {
             cout << "Archivo salida: ";
             getline(cin, out);
             if (out.empty()) out = "ECG_filtrada.txt";
-            s.guardarEnArchivo(out);
+            if (out.size() > 5 && out.compare(out.size() - 5, 5, ".ecgz") == 0)
+                s.guardarComprimido(out);
+            else
+                s.guardarEnArchivo(out);
         }
 
         else if (opcion == 7) {
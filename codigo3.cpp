@@ -1,445 +1,450 @@
-
-
-#include <iostream>
-#include <vector>
-#include <deque>
-#include <string>
-#include <algorithm>
-#include <random>
-#include <ctime>
-#include <limits>
-#include <fstream>
-#include <sstream>
-
-using namespace std;
-
-
-class Ficha {
-private:
-    int a, b;
-public:
-    Ficha(int aa = 0, int bb = 0) : a(aa), b(bb) {}
-    int first() const { return a; }
-    int second() const { return b; }
-    void flip() { swap(a, b); }
-    int pips() const { return a + b; }
-    bool canConnect(int val) const { return a == val || b == val; }
-    void print() const { cout << "[" << a << "|" << b << "]"; }
-    string str() const {
-        ostringstream ss; ss << "[" << a << "|" << b << "]"; 
-        return ss.str();
+#include "juego_domino.h"
+#include <filesystem>
+
+#ifdef DOMINO_CONTAR_ALLOC
+// Compilar con -DDOMINO_CONTAR_ALLOC para contar reservas de memoria (ver --verificar-alloc)
+#include <new>
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"  // new/delete reemplazados usan malloc/free a propósito
+#endif
+static size_t g_reservas = 0;
+void* operator new(size_t n) {
+    ++g_reservas;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+
+#ifdef DOMINO_CONTAR_ALLOC
+// Juega rondas sin consola y comprueba que, tras la primera, ni el reparto ni los turnos
+// (robos del pozo incluidos) reserven memoria
+template <class R>
+bool verificarReservas(const char* variante, int nJugadores) {
+    JuegoDomino<R> game;
+    game.setupPlayersAuto(nJugadores);
+    game.seed(12345);
+    game.simulateRound();  // calentamiento
+    size_t enReparto = 0, enTurnos = 0, turnos = 0, robos = 0;
+    for (int r = 0; r < 1000; ++r) {
+        size_t antes = g_reservas;
+        game.beginSimulatedRound();
+        enReparto += g_reservas - antes;
+        antes = g_reservas;
+        do ++turnos; while (game.simulateTurn() < 0);
+        enTurnos += g_reservas - antes;
+        for (size_t k = 0; k < game.historySize(); ++k) robos += game.historyAt(k).tipo == MOV_ROBA;
     }
-    bool equals(const Ficha& other) const {
-        return (a == other.a && b == other.b) || (a == other.b && b == other.a);
+    cout << variante << ": " << turnos << " turnos, " << robos << " robos; reservas de memoria: "
+         << enReparto << " al repartir, " << enTurnos << " en los turnos\n";
+    if (R::ROBO && robos == 0) cout << "  No se robó ninguna ficha: el camino de robo no quedó cubierto.\n";
+    return enReparto == 0 && enTurnos == 0 && (!R::ROBO || robos > 0);
+}
+#endif
+
+
+// Resuelve finales aleatorios (fichas al azar repartidas en orden, extremos al azar) e informa tiempos
+template <class R>
+void medirSolver(const char* variante, int nJugadores, int fichas, int pruebas) {
+    typedef typename R::Mascara Mascara;
+    mt19937 rng(2025);
+    double total = 0, peor = 0, aciertos = 0;
+    for (int t = 0; t < pruebas; ++t) {
+        int ids[R::NUM_FICHAS];
+        for (int id = 0; id < R::NUM_FICHAS; ++id) ids[id] = id;
+        shuffle(ids, ids + R::NUM_FICHAS, rng);
+        Mascara manos[R::MAX_JUGADORES];
+        for (int i = 0; i < R::MAX_JUGADORES; ++i) manos[i] = Mascara();
+        for (int k = 0; k < fichas; ++k) manos[k % nJugadores] |= R::bit(ids[k]);
+        uniform_int_distribution<int> pip(0, R::MAX_PIP);
+        int izq = pip(rng), der = pip(rng);
+
+        SolverFinal<R> solver;
+        auto t0 = chrono::steady_clock::now();
+        solver.resolver(manos, nJugadores, izq, der, 0);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        total += ms;
+        peor = max(peor, ms);
+        aciertos += solver.tasaAciertos();
     }
-};
-
-
-class Jugador {
-private:
-    string name;
-    vector<Ficha> hand;
-    int wins; // victorias acumuladas
-
-public:
-    Jugador(const string& n = "Jugador") : name(n), wins(0) {}
+    cout << variante << ", " << nJugadores << " jugadores, " << fichas << " fichas: promedio "
+         << total / pruebas << " ms, peor " << peor << " ms, aciertos de caché "
+         << (int)(aciertos / pruebas * 100) << "%\n";
+}
 
-    const string& getName() const { return name; }
-    int getWins() const { return wins; }
-    void addWin() { ++wins; }
 
-    void clearHand() { hand.clear(); }
-    void receive(const Ficha& f) { hand.push_back(f); }
-    int handSize() const { return (int)hand.size(); }
-    int handPips() const {
-        int s = 0;
-        for (const auto& f : hand) s += f.pips();
-        return s;
+// Relee un archivo DOMD y comprueba cada registro: la ficha elegida está en la mano y es legal en
+// su lado, las jugadas legales salen de la mano y los extremos, la mesa solo está vacía en la
+// primera decisión de cada ronda y cada ronda tiene un único lado ganador (que puede sumar 0
+// puntos si los perdedores solo tienen el doble blanco).
+template <class R>
+bool verificarDataset(const string& nombre, uint64_t rondasEsperadas, uint64_t decisionesEsperadas) {
+    typedef typename R::Mascara Mascara;
+    const int B = DatasetDomino<R>::BYTES_MASCARA;
+    FILE* f = fopen(nombre.c_str(), "rb");
+    if (!f) { cout << "No se pudo abrir " << nombre << "\n"; return false; }
+    char magia[4];
+    uint32_t cab[7];
+    uint64_t cuentas[3];
+    bool ok = fread(magia, 4, 1, f) == 1 && memcmp(magia, "DOMD", 4) == 0 && fread(cab, 4, 7, f) == 7 &&
+              fread(cuentas, 8, 3, f) == 3 && cab[0] == DatasetDomino<R>::VERSION &&
+              cab[1] == (uint32_t)R::MAX_PIP && cab[6] == (uint32_t)B;
+    if (!ok) { cout << "Cabecera inválida.\n"; fclose(f); return false; }
+    if (cuentas[1] != rondasEsperadas || cuentas[2] != decisionesEsperadas) {
+        cout << "Cuentas de la cabecera incorrectas.\n"; fclose(f); return false;
     }
 
-    
-    void showHand() const {
-        cout << "\nMano de " << name << " (" << hand.size() << "):\n";
-        for (int i = 0; i < (int)hand.size(); ++i) {
-            cout << i+1 << ". ";
-            hand[i].print();
-            cout << "  ";
-            if ((i+1) % 6 == 0) cout << "\n";
+    vector<uint32_t> ronda;
+    vector<uint8_t> jugador, izq, der, mano, legalIzq, legalDer, ficha, lado, gano;
+    vector<int16_t> puntos;
+    uint64_t leidas = 0, rondasVistas = 0, errores = 0;
+    int64_t rondaActual = -1;
+    int ganadorRonda = -1;
+    while (true) {
+        uint32_t n;
+        if (fread(&n, 4, 1, f) != 1) { cout << "Archivo truncado.\n"; fclose(f); return false; }
+        if (n == 0) break;
+        ronda.resize(n); jugador.resize(n); izq.resize(n); der.resize(n);
+        mano.resize((size_t)n * B); legalIzq.resize((size_t)n * B); legalDer.resize((size_t)n * B);
+        ficha.resize(n); lado.resize(n); gano.resize(n); puntos.resize(n);
+        bool completo = fread(ronda.data(), 4, n, f) == n && fread(jugador.data(), 1, n, f) == n &&
+                        fread(izq.data(), 1, n, f) == n && fread(der.data(), 1, n, f) == n &&
+                        fread(mano.data(), B, n, f) == n && fread(legalIzq.data(), B, n, f) == n &&
+                        fread(legalDer.data(), B, n, f) == n && fread(ficha.data(), 1, n, f) == n &&
+                        fread(lado.data(), 1, n, f) == n && fread(gano.data(), 1, n, f) == n &&
+                        fread(puntos.data(), 2, n, f) == n;
+        if (!completo) { cout << "Bloque truncado.\n"; fclose(f); return false; }
+
+        for (uint32_t i = 0; i < n; ++i) {
+            Mascara m, li, ld;
+            bytesAMascara(&mano[(size_t)i * B], B, m);
+            bytesAMascara(&legalIzq[(size_t)i * B], B, li);
+            bytesAMascara(&legalDer[(size_t)i * B], B, ld);
+            bool nueva = (int64_t)ronda[i] != rondaActual;
+            if (nueva) {
+                if ((int64_t)ronda[i] != rondaActual + 1) ++errores;
+                rondaActual = ronda[i];
+                ganadorRonda = -1;
+                ++rondasVistas;
+            }
+            bool vacia = izq[i] == 255;
+            bool bien = ficha[i] < R::NUM_FICHAS && R::tiene(m, ficha[i]) && vacia == nueva;
+            if (vacia) {
+                bien = bien && der[i] == 255 && li == Mascara() && ld == m && lado[i] == LADO_DER;
+            } else {
+                bien = bien && izq[i] <= R::MAX_PIP && der[i] <= R::MAX_PIP &&
+                       li == (m & R::conValor(izq[i])) && ld == (m & R::conValor(der[i])) &&
+                       R::tiene(lado[i] == LADO_IZQ ? li : ld, ficha[i]);
+            }
+            int l = R::EQUIPOS ? jugador[i] % 2 : jugador[i];
+            if (gano[i]) {
+                bien = bien && puntos[i] >= 0 && (ganadorRonda == -1 || ganadorRonda == l);
+                ganadorRonda = l;
+            } else {
+                bien = bien && gano[i] == 0 && puntos[i] <= 0 && ganadorRonda != l;
+            }
+            if (!bien) ++errores;
         }
-        cout << "\n";
+        leidas += n;
     }
-
-    bool hasPlayable(int left, int right) const {
-        if (left == -1 && right == -1) return !hand.empty();
-        for (const auto& f : hand) if (f.canConnect(left) || f.canConnect(right)) return true;
+    fclose(f);
+    if (leidas != decisionesEsperadas || rondasVistas != rondasEsperadas) {
+        cout << "Se leyeron " << leidas << " decisiones en " << rondasVistas << " rondas.\n";
         return false;
     }
+    if (errores) cout << errores << " registros inconsistentes.\n";
+    return errores == 0;
+}
 
-    
-    Ficha tileAt(int idx) const { return hand[idx]; }
-
-   
-    Ficha playAt(int idx) {
-        Ficha t = hand[idx];
-        hand.erase(hand.begin() + idx);
-        return t;
+// Genera decisiones de autojuego hasta llegar a 'objetivo', compara el ritmo con la misma
+// simulación sin exportar y valida el archivo
+template <class R>
+bool generarDataset(const char* variante, int jugadores, uint64_t objetivo, const string& nombre) {
+    const uint64_t SEMILLA = 12345;
+    uint64_t rondas;
+    double segExportando, segSimulando;
+    long bytes;
+    {
+        JuegoDomino<R> game;
+        game.setupPlayersAuto(jugadores);
+        game.seed(SEMILLA);
+        DatasetDomino<R> dataset;
+        if (!dataset.abrir(nombre, jugadores, SEMILLA)) {
+            cout << "No se pudo crear " << nombre << "\n";
+            return false;
+        }
+        auto t0 = chrono::steady_clock::now();
+        while (dataset.numDecisiones() < objetivo) game.simulateRound(&dataset);
+        dataset.cerrar();
+        segExportando = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        rondas = dataset.numRondas();
+        objetivo = dataset.numDecisiones();
     }
-};
-
-
-struct HistNode {
-    string jugador;
-    string ficha;    // texto de la ficha jugada, o "PASA"
-    string tablero;  // estado completo del tablero después del movimiento
-    HistNode* sig;
-    HistNode(const string& j, const string& f, const string& t) : jugador(j), ficha(f), tablero(t), sig(nullptr) {}
-};
-
-
-class JuegoDomino {
-private:
-    vector<Ficha> deck;        
-    deque<Ficha> table;        
-    vector<Ficha> boneyard;    
-    vector<Jugador*> players;  
-    int currentIdx;            
-    mt19937 rng;
+    {
+        JuegoDomino<R> game;
+        game.setupPlayersAuto(jugadores);
+        game.seed(SEMILLA);
+        auto t0 = chrono::steady_clock::now();
+        for (uint64_t r = 0; r < rondas; ++r) game.simulateRound();
+        segSimulando = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    }
+    {
+        FILE* f = fopen(nombre.c_str(), "rb");
+        fseek(f, 0, SEEK_END);
+        bytes = ftell(f);
+        fclose(f);
+    }
+    cout << variante << ", " << jugadores << " jugadores: " << objetivo << " decisiones en " << rondas << " rondas, "
+         << bytes / 1048576.0 << " MiB (" << (double)bytes / objetivo << " bytes por decisión)\n";
+    cout << "  solo simulación: " << objetivo / segSimulando << " decisiones/s; exportando: "
+         << objetivo / segExportando << " decisiones/s\n";
+    bool ok = verificarDataset<R>(nombre, rondas, objetivo);
+    cout << (ok ? "  Archivo verificado.\n" : "  Archivo con errores.\n");
+    return ok;
+}
 
-    
-    HistNode* histHead;
-    HistNode* histTail;
 
-    // crear 28 fichas
-    void createDeck() {
-        deck.clear();
-        for (int i = 0; i <= 6; ++i)
-            for (int j = i; j <= 6; ++j)
-                deck.emplace_back(i, j);
-    }
+// Mismas manos, pozo y mesa (fichas y orientación); con la ronda en curso, también turno y pases
+template <class R>
+bool mismoEstado(const EstadoDomino<R>& a, const EstadoDomino<R>& b, bool enCurso) {
+    for (int i = 0; i < R::MAX_JUGADORES; ++i) if (a.manos[i] != b.manos[i]) return false;
+    if (a.pozo != b.pozo || a.mesa.size() != b.mesa.size() || a.terminada != b.terminada) return false;
+    for (int k = 0; k < a.mesa.size(); ++k)
+        if (a.mesa.begin()[k].first() != b.mesa.begin()[k].first() || a.mesa.begin()[k].second() != b.mesa.begin()[k].second())
+            return false;
+    return !enCurso || (a.turno == b.turno && a.pasesSeguidos == b.pasesSeguidos);
+}
 
-    
-    void shuffleDeck() {
-        shuffle(deck.begin(), deck.end(), rng);
-    }
+static bool leerBytes(const string& nombre, string& b) {
+    ifstream in(nombre, ios::binary);
+    if (!in) return false;
+    b.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return true;
+}
+static void escribirBytes(const string& nombre, const string& b) {
+    ofstream(nombre, ios::binary).write(b.data(), b.size());
+}
 
-    // repartir 7 fichas por jugador; 
-    void dealHands() {
-        for (auto p : players) p->clearHand();
-        
-        int idx = 0;
-        int per = 7;
-        for (int r = 0; r < per; ++r) {
-            for (auto p : players) {
-                if (idx < (int)deck.size()) {
-                    p->receive(deck[idx++]);
-                }
-            }
-        }
-       
-        boneyard.clear();
-        while (idx < (int)deck.size()) boneyard.push_back(deck[idx++]);
-    }
+// Un archivo dañado debe rechazarse al cargar o al validar
+template <class R>
+bool rechazado(const string& archivo, const char* caso) {
+    ReplayDomino<R> replay;
+    bool aceptado = replay.cargar(archivo) && replay.validar();
+    if (aceptado) cout << "  ERROR: se aceptó " << caso << "\n";
+    return !aceptado;
+}
 
-    // 
-    int determineStarter() {
-        int starter = 0;
-        int bestDouble = -1;
-        for (int i = 0; i < (int)players.size(); ++i) {
-            for (int k = 0; k < players[i]->handSize(); ++k) {
-                const Ficha& f = players[i]->tileAt(k);
-                if (f.first() == f.second()) {
-                    if (f.first() > bestDouble) {
-                        bestDouble = f.first();
-                        starter = i;
-                    }
-                }
+// Guardar -> cargar -> validar -> irA de punta a punta: simula rondas con semilla fija, las guarda en
+// texto y en binario, las vuelve a cargar y compara irA(k) con el estado vivo al final de cada turno
+// (k dentro y fuera de los estados de control). Al final daña los archivos de la última ronda.
+// Usa la carpeta "prueba_historial"
+template <class R>
+bool verificarHistorial(const char* variante, int jugadores, int rondas) {
+    // nombres repetidos, con " | " y con palabras del formato: el historial no debe confundirlos
+    static const char* const NOMBRES[] = { "Ana", "Ana", "MANO INICIAL", "a | b", "SYSTEM", "Luis", "Luis", "8" };
+    const string base = "prueba_historial/historial";
+    JuegoDomino<R> game;
+    game.setupPlayersAuto(vector<string>(NOMBRES, NOMBRES + jugadores));
+    game.seed(2024);
+    size_t comparados = 0, enControl = 0, errores = 0;
+    vector<pair<size_t, EstadoDomino<R>>> vivos;
+    EstadoDomino<R> e;
+    for (int r = 0; r < rondas; ++r) {
+        vivos.clear();
+        game.beginSimulatedRound();
+        do {
+            game.estadoActual(e);
+            vivos.push_back(make_pair(game.historySize(), e));
+        } while (game.simulateTurn() < 0);
+        game.estadoActual(e);
+        game.saveHistoryAs(base);
+        for (const char* ext : { ".txt", ".bin" }) {
+            ReplayDomino<R> replay;
+            if (!replay.cargar(base + ext) || !replay.validar()) {
+                cout << "  ronda " << r + 1 << " (" << ext << "): " << replay.mensajeError() << "\n";
+                ++errores;
+                continue;
             }
-        }
-        if (bestDouble != -1) return starter;
-        
-        int bestSum = -1;
-        for (int i = 0; i < (int)players.size(); ++i) {
-            for (int k = 0; k < players[i]->handSize(); ++k) {
-                int s = players[i]->tileAt(k).pips();
-                if (s > bestSum) { bestSum = s; starter = i; }
+            bool bien = replay.numMovimientos() == game.historySize() && replay.numJugadores() == jugadores;
+            for (int i = 0; bien && i < jugadores; ++i) bien = replay.nombre(i) == NOMBRES[i];
+            EstadoDomino<R> x;
+            for (const auto& v : vivos) {
+                bien = bien && replay.irA(v.first, x) && mismoEstado(x, v.second, true);
+                ++comparados;
+                if (v.first % 8 == 0) ++enControl;
             }
+            bien = bien && replay.irA(replay.numMovimientos(), x) && x.terminada && mismoEstado(x, e, false);
+            if (!bien) ++errores;
         }
-        return starter;
     }
 
-    void showTable() const {
-        cout << "\n--- MESA ---\n";
-        if (table.empty()) cout << "(vacía)\n";
-        else {
-            for (const auto& f : table) { f.print(); cout << " "; }
-            cout << "\nExtremos: " << table.front().first() << " ... " << table.back().second() << "\n";
-        }
-        cout << "-------------\n";
-    }
+    // archivos dañados a partir de la última ronda
+    string bin, txt;
+    leerBytes(base + ".bin", bin);
+    leerBytes(base + ".txt", txt);
+    escribirBytes(base + "_cortado.bin", bin.substr(0, bin.size() - 3));
+    string enorme = bin;
+    size_t posM = bin.size() - game.historySize() * sizeof(Movimiento) - 4;
+    uint32_t m = 0xFFFFFFF0u;
+    memcpy(&enorme[posM], &m, 4);
+    escribirBytes(base + "_enorme.bin", enorme);
+    size_t ultima = txt.rfind('\n', txt.size() - 2);
+    escribirBytes(base + "_incompleto.txt", txt.substr(0, ultima + 1));
+    // primer movimiento atribuido al jugador siguiente (mismo nombre si es "Ana")
+    string otro = txt;
+    size_t mov = otro.find("\n\n") + 2;
+    int j = atoi(otro.c_str() + mov);
+    string num = to_string(j), sig = to_string(j % jugadores + 1);
+    otro.replace(mov, num.size(), sig);
+    size_t finLinea = otro.find('\n', mov);
+    size_t nm = otro.rfind(" | ", finLinea) + 3;
+    otro.replace(nm, finLinea - nm, NOMBRES[j % jugadores]);
+    escribirBytes(base + "_otro_jugador.txt", otro);
+    bool rechazos = rechazado<R>(base + "_cortado.bin", "un binario cortado") &&
+                    rechazado<R>(base + "_enorme.bin", "un binario con 4G movimientos") &&
+                    rechazado<R>(base + "_incompleto.txt", "un texto sin el último movimiento") &&
+                    rechazado<R>(base + "_otro_jugador.txt", "un movimiento del jugador equivocado");
+
+    cout << variante << ", " << jugadores << " jugadores: " << rondas << " rondas en texto y binario, " << comparados
+         << " estados comparados (" << enControl << " en estados de control), " << errores << " errores; "
+         << (rechazos ? "archivos dañados rechazados" : "ARCHIVO DAÑADO ACEPTADO") << "\n";
+    return errores == 0 && rechazos && enControl > 0 && enControl < comparados;
+}
 
-    bool isBlocked() const {
-        if (table.empty()) return false;
-        int L = table.front().first();
-        int R = table.back().second();
-        for (auto p : players) if (p->hasPlayable(L, R)) return false;
-        return true;
-    }
 
- 
-    string tableToString() const {
-        ostringstream ss;
-        for (const auto& f : table) ss << f.str();
-        return ss.str();
-    }
+#ifdef DOMINO_ESTADISTICAS
+// Simula rondas sin consola y agrega el informe de la variante
+template <class R>
+void simularEstadisticas(ostream& os, const char* variante, int jugadores, int rondas, bool primera) {
+    JuegoDomino<R> game;
+    game.setupPlayersAuto(jugadores);
+    game.seed(12345);
+    for (int r = 0; r < rondas; ++r) game.simulateRound();
+    const EstadisticasDomino& e = game.estadisticas();
+    os << (primera ? "  " : ",\n  ");
+    e.exportarJSON(os, variante, jugadores);
+    cout << variante << ": " << e.rondas << " rondas, " << e.turnos << " turnos, " << e.bloqueos
+         << " bloqueos, margen promedio " << (double)e.sumaMargen / e.rondas << " pips, "
+         << e.rondaNs / e.rondas << " ns por ronda\n";
+}
+#endif
 
-   
-    void addHistory(const string& jugador, const string& fichaText, const string& estado = "") {
-        string estadoFinal = estado.empty() ? tableToString() : estado;
-        HistNode* node = new HistNode(jugador, fichaText, estadoFinal);
-        if (!histHead) {
-            histHead = histTail = node;
-        } else {
-            histTail->sig = node;
-            histTail = node;
-        }
-    }
 
-    // Guarda historial en archivo "historial_domino.txt"
-    void saveHistoryToFile() const {
-        const string filename = "historial_domino.txt";
-        ofstream ofs(filename);
-        if (!ofs.is_open()) {
-            cerr << "Error: no se pudo escribir el archivo de historial.\n";
-            return;
-        }
-        ofs << "HISTORIAL DE MOVIMIENTOS - Dominó\n";
-        ofs << "Formato: Jugador | Ficha (o PASA) | Estado del tablero después del movimiento\n\n";
-        HistNode* cur = histHead;
-        while (cur) {
-            ofs << cur->jugador << " | " << cur->ficha << " | " << cur->tablero << "\n";
-            cur = cur->sig;
-        }
-        ofs.close();
-    }
+template <class R>
+void jugar(const char* variante) {
+    JuegoDomino<R> game;
+    game.mainMenu();
+#ifdef DOMINO_ESTADISTICAS
+    ofstream ofs("estadisticas_domino.json");
+    ofs << "[\n  ";
+    game.estadisticas().exportarJSON(ofs, variante, game.playerCount());
+    ofs << "\n]\n";
+    cout << "Estadísticas guardadas en 'estadisticas_domino.json'\n";
+#else
+    (void)variante;
+#endif
+}
 
-    // Borra la lista de historial (libera memoria)
-    void clearHistory() {
-        HistNode* cur = histHead;
-        while (cur) {
-            HistNode* tmp = cur;
-            cur = cur->sig;
-            delete tmp;
-        }
-        histHead = histTail = nullptr;
-    }
 
-public:
-    JuegoDomino() : currentIdx(0), histHead(nullptr), histTail(nullptr) {
-        rng.seed(static_cast<unsigned>(time(nullptr)));
+int main(int argc, char** argv) {
+#ifdef DOMINO_CONTAR_ALLOC
+    if (argc > 1 && string(argv[1]) == "--verificar-alloc") {
+        bool ok = verificarReservas<DobleSeis>("Doble seis", 4);
+        ok = verificarReservas<DobleSeisParejas>("Doble seis por parejas", 4) && ok;
+        // con robo se verifica con 2 jugadores: con 4 se reparten las 28 fichas y nunca se roba
+        ok = verificarReservas<DobleSeisRobo>("Doble seis con robo", 2) && ok;
+        ok = verificarReservas<DobleNueve>("Doble nueve", DobleNueve::MAX_JUGADORES) && ok;
+        ok = verificarReservas<DobleDoce>("Doble doce", DobleDoce::MAX_JUGADORES) && ok;
+        ok = verificarReservas<DobleQuince>("Doble quince", DobleQuince::MAX_JUGADORES) && ok;
+        return ok ? 0 : 1;
     }
-
-    ~JuegoDomino() {
-        // liberar memoria jugadores
-        for (auto p : players) delete p;
-        players.clear();
-        // guardar historial (por si acaso) y liberar
-        saveHistoryToFile();
-        clearHistory();
+#endif
+    if (argc > 1 && string(argv[1]) == "--verificar-historial") {
+        int rondas = argc > 2 ? atoi(argv[2]) : 200;
+        if (rondas <= 0) rondas = 200;
+        const string carpeta = "prueba_historial";
+        error_code ec;
+        filesystem::remove_all(carpeta, ec);
+        filesystem::create_directory(carpeta, ec);
+        bool ok = verificarHistorial<DobleSeis>("Doble seis", 4, rondas);
+        ok = verificarHistorial<DobleSeisParejas>("Doble seis por parejas", 4, rondas) && ok;
+        ok = verificarHistorial<DobleSeisRobo>("Doble seis con robo", 2, rondas) && ok;
+        ok = verificarHistorial<DobleNueve>("Doble nueve", 5, rondas) && ok;
+        ok = verificarHistorial<DobleDoce>("Doble doce", 7, rondas) && ok;
+        ok = verificarHistorial<DobleQuince>("Doble quince", 8, rondas) && ok;
+        filesystem::remove_all(carpeta, ec);
+        return ok ? 0 : 1;
     }
-
-    // configurar N jugadores humanos
-    void setupPlayersInteractive() {
-        for (auto p : players) delete p;
-        players.clear();
-
-        int n;
-        while (true) {
-            cout << "¿Cuántos jugadores? (2-4): ";
-            if (!(cin >> n)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
-            if (n >= 2 && n <= 4) break;
-            cout << "Ingrese entre 2 y 4.\n";
-        }
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        for (int i = 0; i < n; ++i) {
-            string nm;
-            cout << "Nombre jugador " << i+1 << ": ";
-            getline(cin, nm);
-            if (nm.empty()) nm = "Jugador" + to_string(i+1);
-            players.push_back(new Jugador(nm));
+    if (argc > 1 && string(argv[1]) == "--resolver-finales") {
+        medirSolver<DobleSeis>("Doble seis", 4, 8, 200);
+        medirSolver<DobleSeis>("Doble seis", 4, 12, 200);
+        medirSolver<DobleSeis>("Doble seis", 2, 12, 200);
+        medirSolver<DobleSeisParejas>("Doble seis por parejas", 4, 12, 200);
+        medirSolver<DobleNueve>("Doble nueve", 4, 12, 200);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--generar-dataset") {
+        // --generar-dataset [decisiones] [variante 1-6] [archivo]
+        long long pedidas = argc > 2 ? atoll(argv[2]) : 1000000;
+        if (pedidas <= 0) pedidas = 1000000;
+        int v = argc > 3 ? atoi(argv[3]) : 1;
+        string archivo = argc > 4 ? argv[4] : "dataset_domino.bin";
+        uint64_t n = (uint64_t)pedidas;
+        bool ok;
+        switch (v) {
+            case 2: ok = generarDataset<DobleSeisParejas>("Doble seis por parejas", 4, n, archivo); break;
+            case 3: ok = generarDataset<DobleSeisRobo>("Doble seis con robo", 2, n, archivo); break;
+            case 4: ok = generarDataset<DobleNueve>("Doble nueve", 5, n, archivo); break;
+            case 5: ok = generarDataset<DobleDoce>("Doble doce", 7, n, archivo); break;
+            case 6: ok = generarDataset<DobleQuince>("Doble quince", 8, n, archivo); break;
+            default: ok = generarDataset<DobleSeis>("Doble seis", 4, n, archivo); break;
         }
+        return ok ? 0 : 1;
     }
-
-    
-    void startRound() {
-        // limpiar historial anterior
-        clearHistory();
-
-        createDeck();
-        shuffleDeck();
-        dealHands();
-        table.clear();
-        currentIdx = determineStarter();
-        cout << "\nInicia la ronda. Comienza: " << players[currentIdx]->getName() << "\n";
-        playRound();
+    if (argc > 1 && string(argv[1]) == "--estadisticas") {
+#ifdef DOMINO_ESTADISTICAS
+        int rondas = argc > 2 ? atoi(argv[2]) : 10000;
+        if (rondas <= 0) rondas = 10000;
+        ofstream ofs("estadisticas_domino.json");
+        ofs << "[\n";
+        simularEstadisticas<DobleSeis>(ofs, "Doble seis", 4, rondas, true);
+        simularEstadisticas<DobleSeisParejas>(ofs, "Doble seis por parejas", 4, rondas, false);
+        simularEstadisticas<DobleSeisRobo>(ofs, "Doble seis con robo", 2, rondas, false);
+        simularEstadisticas<DobleNueve>(ofs, "Doble nueve", 5, rondas, false);
+        simularEstadisticas<DobleDoce>(ofs, "Doble doce", 7, rondas, false);
+        simularEstadisticas<DobleQuince>(ofs, "Doble quince", 8, rondas, false);
+        ofs << "\n]\n";
+        cout << "Informe guardado en 'estadisticas_domino.json'\n";
+        return 0;
+#else
+        cout << "Compile con -DDOMINO_ESTADISTICAS para habilitar las estadísticas.\n";
+        return 1;
+#endif
     }
-
-    
-    void playRound() {
-        int passesInRow = 0; 
-        bool roundActive = true;
-
-        while (roundActive) {
-            showTable();
-
-            Jugador* cur = players[currentIdx];
-            cout << "\nTurno: " << cur->getName() << "\n";
-            cur->showHand();
-
-            int L = table.empty() ? -1 : table.front().first();
-            int R = table.empty() ? -1 : table.back().second();
-
-            bool playedThisTurn = false;
-
-            // si no puede jugar y no hay mesa vacía -> pasar
-            if (!table.empty() && !cur->hasPlayable(L,R)) {
-                cout << cur->getName() << " no tiene jugadas válidas y pasa.\n";
-                passesInRow++;
-                // registramos PASS en historial (no se cambia el tablero)
-                addHistory(cur->getName(), string("PASA"));
-            } else {
-                // pedir acción al jugador
-                int choice = -1;
-                while (true) {
-                    cout << "Ingrese índice de ficha a jugar (1-" << cur->handSize() << ") o 0 para pasar: ";
-                    if (!(cin >> choice)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout << "Entrada inválida.\n"; continue; }
-                    if (choice == 0) { cout << cur->getName() << " pasa.\n"; passesInRow++; addHistory(cur->getName(), string("PASA")); break; }
-                    int idx = choice - 1;
-                    if (idx < 0 || idx >= cur->handSize()) { cout << "Índice fuera de rango.\n"; continue; }
-                    Ficha candidate = cur->tileAt(idx);
-                    // si mesa vacía aceptar directamente
-                    if (table.empty()) {
-                        Ficha played = cur->playAt(idx); // sacamos la ficha real
-                        table.push_back(played);
-                        cout << cur->getName() << " coloca "; table.back().print(); cout << " (mesa vacía)\n";
-                        // registrar en historial (ficha jugada y estado del tablero)
-                        addHistory(cur->getName(), played.str());
-                        passesInRow = 0;
-                        playedThisTurn = true;
-                        break;
-                    }
-                    // else preguntar lado
-                    char side;
-                    cout << "Colocar en (I)zquierda o (D)erecha? ";
-                    cin >> side; side = toupper(side);
-                    if (side != 'I' && side != 'D') { cout << "Lado inválido.\n"; continue; }
-
-                    int need = (side == 'I') ? L : R;
-                    if (!candidate.canConnect(need)) { cout << "Esa ficha no encaja en ese lado.\n"; continue; }
-
-                    // remove the real tile from player's hand, then orient that returned tile before inserting
-                    Ficha played = cur->playAt(idx);
-                    if (side == 'I') {
-                        // queremos que played.second() == need
-                        if (played.second() != need) played.flip();
-                        table.push_front(played);
-                        cout << cur->getName() << " coloca en izquierda "; table.front().print(); cout << "\n";
-                    } else {
-                        // queremos que played.first() == need
-                        if (played.first() != need) played.flip();
-                        table.push_back(played);
-                        cout << cur->getName() << " coloca en derecha "; table.back().print(); cout << "\n";
-                    }
-                    // registrar en historial
-                    addHistory(cur->getName(), played.str());
-                    passesInRow = 0;
-                    playedThisTurn = true;
-                    break;
-                } // end action loop
-            }
-
-            // check win
-            if (cur->handSize() == 0) {
-                cout << "\n***** " << cur->getName() << " se quedó sin fichas y gana la ronda! *****\n";
-                cur->addWin();
-                roundActive = false;
-            } else {
-                // check bloqueo: if passesInRow >= players.size() => blocked OR isBlocked()
-                if (passesInRow >= (int)players.size() || isBlocked()) {
-                    cout << "\n***** Ronda BLOQUEADA *****\n";
-                    // determine winner by lowest hand pips
-                    int winner = 0;
-                    int minPips = players[0]->handPips();
-                    for (int i = 1; i < (int)players.size(); ++i) {
-                        int pips = players[i]->handPips();
-                        cout << players[i]->getName() << " tiene " << pips << " pips.\n";
-                        if (pips < minPips) { minPips = pips; winner = i; }
-                    }
-                    cout << players[winner]->getName() << " tiene menor pips (" << minPips << ") y gana la ronda.\n";
-                    players[winner]->addWin();
-                    // registrar en historial que la ronda terminó por bloqueo (registro final)
-                    addHistory(string("SYSTEM"), string("BLOQUEO"), string("Ronda finalizada por bloqueo"));
-                    roundActive = false;
-                }
-            }
-
-            // Avanzar al siguiente jugador siempre si la ronda sigue
-            if (roundActive) {
-                currentIdx = (currentIdx + 1) % players.size();
-            }
-        } // end while roundActive
-
-        // mostrar victorias acumuladas
-        cout << "\nVictorias acumuladas:\n";
-        for (auto p : players) cout << p->getName() << ": " << p->getWins() << "\n";
-
-        // Al finalizar la ronda, guardamos historial
-        saveHistoryToFile();
-        cout << "\nHistorial guardado en 'historial_domino.txt'\n";
+    int variante;
+    while (true) {
+        cout << "=== VARIANTE ===\n";
+        cout << "1) Doble seis (clásico, 2-4 jugadores)\n";
+        cout << "2) Doble seis por parejas (4 jugadores)\n";
+        cout << "3) Doble seis con robo del pozo (2-4 jugadores)\n";
+        cout << "4) Doble nueve (2-5 jugadores)\n";
+        cout << "5) Doble doce (2-7 jugadores)\n";
+        cout << "6) Doble quince (2-8 jugadores)\n";
+        cout << "Seleccione variante: ";
+        if (!(cin >> variante)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
+        if (variante >= 1 && variante <= 6) break;
+        cout << "Opcion no valida.\n";
     }
-
-    // menu principal / control de sesiones y reinicio
-    void mainMenu() {
-        bool running = true;
-        while (running) {
-            cout << "\n=== MENU PRINCIPAL ===\n";
-            cout << "1) Configurar jugadores\n";
-            cout << "2) Nueva ronda\n";
-            cout << "3) Ver marcador\n";
-            cout << "4) Reiniciar marcador y jugadores\n";
-            cout << "5) Salir\n";
-            cout << "Seleccione opcion: ";
-            int opt;
-            if (!(cin >> opt)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
-            switch (opt) {
-                case 1:
-                    setupPlayersInteractive();
-                    break;
-                case 2:
-                    if (players.empty()) { cout << "Configure jugadores primero (opcion 1).\n"; break; }
-                    startRound();
-                    break;
-                case 3:
-                    for (auto p : players) cout << p->getName() << ": " << p->getWins() << " victorias\n";
-                    break;
-                case 4:
-                    for (auto p : players) { p->clearHand(); delete p; }
-                    players.clear();
-                    cout << "Marcador y jugadores reiniciados. Configure nuevamente.\n";
-                    break;
-                case 5:
-                    running = false;
-                    break;
-                default:
-                    cout << "Opcion no valida.\n";
-            }
-        }
+    switch (variante) {
+        case 1: jugar<DobleSeis>("Doble seis"); break;
+        case 2: jugar<DobleSeisParejas>("Doble seis por parejas"); break;
+        case 3: jugar<DobleSeisRobo>("Doble seis con robo"); break;
+        case 4: jugar<DobleNueve>("Doble nueve"); break;
+        case 5: jugar<DobleDoce>("Doble doce"); break;
+        case 6: jugar<DobleQuince>("Doble quince"); break;
     }
-};
-
-
-int main() {
-    JuegoDomino game;
-    game.mainMenu();
     cout << "Gracias por jugar. Fin.\n";
     return 0;
 }
@@ -0,0 +1,1826 @@
+// Dominó con reglas por plantilla: fichas, manos y mesa de tamaño fijo, historial compacto con reproducción,
+// solucionador de finales y exportación de autojuego.
+// Lo usan codigo3.cpp y benchmark.cpp.
+#ifndef JUEGO_DOMINO_H
+#define JUEGO_DOMINO_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <ctime>
+#include <limits>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <bitset>
+#include <unordered_map>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+
+class Ficha {
+private:
+    int a, b;
+public:
+    Ficha(int aa = 0, int bb = 0) : a(aa), b(bb) {}
+    int first() const { return a; }
+    int second() const { return b; }
+    void flip() { swap(a, b); }
+    int pips() const { return a + b; }
+    bool canConnect(int val) const { return a == val || b == val; }
+    void print(ostream& os = cout) const { os << "[" << a << "|" << b << "]"; }
+    string str() const {
+        char buf[16];  // "[a|b]" cabe en el buffer interno de string: no reserva memoria
+        snprintf(buf, sizeof buf, "[%d|%d]", a, b);
+        return buf;
+    }
+    bool equals(const Ficha& other) const {
+        return (a == other.a && b == other.b) || (a == other.b && b == other.a);
+    }
+};
+
+
+// Máscara de fichas (bit i = ficha con id i): entero de 32 o 64 bits si alcanza, bitset si no
+template <int N, bool Chica = (N <= 32), bool Mediana = (N <= 64)>
+struct TipoMascara { typedef bitset<N> tipo; };
+template <int N> struct TipoMascara<N, true, true> { typedef uint32_t tipo; };
+template <int N> struct TipoMascara<N, false, true> { typedef uint64_t tipo; };
+
+// Reglas de una variante, elegidas en compilación: tamaño del juego (doble MaxPip),
+// fichas por mano, máximo de jugadores, juego por parejas (0 y 2 contra 1 y 3) y
+// robo del pozo (quien no puede jugar roba hasta poder hacerlo o vaciar el pozo).
+// Las tablas de fichas y máscaras se generan una vez por variante.
+template <int MaxPip, int Mano, int MaxJugadores, bool Equipos = false, bool Robo = false>
+struct Reglas {
+    static const int MAX_PIP = MaxPip;
+    static const int NUM_FICHAS = (MaxPip + 1) * (MaxPip + 2) / 2;
+    static const int MANO = Mano;
+    static const int MIN_JUGADORES = Equipos ? 4 : 2;
+    static const int MAX_JUGADORES = MaxJugadores;
+    static const bool EQUIPOS = Equipos;
+    static const bool ROBO = Robo;
+    typedef typename TipoMascara<NUM_FICHAS>::tipo Mascara;
+
+    static_assert(Mano * MaxJugadores <= NUM_FICHAS, "no alcanzan las fichas para repartir");
+    static_assert(!Equipos || MaxJugadores == 4, "el juego por parejas es de 4 jugadores");
+    static_assert(MaxJugadores < 256 && NUM_FICHAS <= 256, "Movimiento guarda jugador y ficha en un byte");
+
+    // id de una ficha en el orden de createDeck (sin importar su orientación)
+    static int id(const Ficha& f) {
+        int i = min(f.first(), f.second());
+        int j = max(f.first(), f.second());
+        return i * (MAX_PIP + 1) - i * (i - 1) / 2 + (j - i);
+    }
+    // ficha canónica (i <= j) correspondiente a un id
+    static const Ficha& ficha(int id) { return tablas().fichas[id]; }
+    static const Mascara& bit(int id) { return tablas().bits[id]; }
+    // fichas que contienen el valor v
+    static const Mascara& conValor(int v) { return tablas().valor[v]; }
+    static bool tiene(const Mascara& m, int id) { return (m & bit(id)) != Mascara(); }
+
+    // reglas completas en texto: se guardan en los historiales y se comparan al cargarlos
+    static string firma(int pip = MAX_PIP, int mano = MANO, int jugadores = MAX_JUGADORES,
+                        bool equipos = EQUIPOS, bool robo = ROBO) {
+        return "doble " + to_string(pip) + ", mano " + to_string(mano) + ", hasta " + to_string(jugadores) +
+               " jugadores" + (equipos ? ", parejas" : "") + (robo ? ", robo" : "");
+    }
+
+private:
+    struct Tablas {
+        Ficha fichas[NUM_FICHAS];
+        Mascara bits[NUM_FICHAS];
+        Mascara valor[MAX_PIP + 1];
+    };
+    static const Tablas& tablas() {
+        static const Tablas t = [] {
+            Tablas t{};
+            int k = 0;
+            for (int i = 0; i <= MAX_PIP; ++i)
+                for (int j = i; j <= MAX_PIP; ++j, ++k) {
+                    t.fichas[k] = Ficha(i, j);
+                    t.bits[k] = Mascara(1);
+                    t.bits[k] <<= k;
+                    t.valor[i] |= t.bits[k];
+                    t.valor[j] |= t.bits[k];
+                }
+            return t;
+        }();
+        return t;
+    }
+};
+
+typedef Reglas<6, 7, 4> DobleSeis;
+typedef Reglas<6, 7, 4, true> DobleSeisParejas;
+typedef Reglas<6, 7, 4, false, true> DobleSeisRobo;
+typedef Reglas<9, 10, 5> DobleNueve;
+typedef Reglas<12, 12, 7> DobleDoce;
+typedef Reglas<15, 15, 8> DobleQuince;
+
+
+template <class R>
+class Jugador {
+private:
+    string name;
+    Ficha hand[R::NUM_FICHAS];  // capacidad fija: nunca se reserva memoria durante la ronda
+    int handCount;
+    int wins; // victorias acumuladas
+
+public:
+    Jugador(const string& n = "Jugador") : name(n), handCount(0), wins(0) {}
+
+    const string& getName() const { return name; }
+    int getWins() const { return wins; }
+    void addWin() { ++wins; }
+
+    void clearHand() { handCount = 0; }
+    void receive(const Ficha& f) { hand[handCount++] = f; }
+    int handSize() const { return handCount; }
+    int handPips() const {
+        int s = 0;
+        for (int i = 0; i < handCount; ++i) s += hand[i].pips();
+        return s;
+    }
+
+
+    void showHand() const {
+        cout << "\nMano de " << name << " (" << handCount << "):\n";
+        for (int i = 0; i < handCount; ++i) {
+            cout << i+1 << ". ";
+            hand[i].print();
+            cout << "  ";
+            if ((i+1) % 6 == 0) cout << "\n";
+        }
+        cout << "\n";
+    }
+
+    bool hasPlayable(int left, int right) const {
+        if (left == -1 && right == -1) return handCount > 0;
+        for (int i = 0; i < handCount; ++i) if (hand[i].canConnect(left) || hand[i].canConnect(right)) return true;
+        return false;
+    }
+
+
+    Ficha tileAt(int idx) const { return hand[idx]; }
+
+
+    // conserva el orden de la mano (corrimiento dentro del arreglo fijo)
+    Ficha playAt(int idx) {
+        Ficha t = hand[idx];
+        for (int i = idx + 1; i < handCount; ++i) hand[i - 1] = hand[i];
+        --handCount;
+        return t;
+    }
+};
+
+
+// Movimiento codificado del historial (4 bytes, sin strings)
+enum TipoMovimiento : uint8_t { MOV_JUGADA = 0, MOV_PASA = 1, MOV_BLOQUEO = 2, MOV_ROBA = 3 };
+enum LadoMesa : uint8_t { LADO_IZQ = 0, LADO_DER = 1 };
+
+struct Movimiento {
+    uint8_t jugador;  // índice del jugador en la ronda
+    uint8_t ficha;    // id de la ficha jugada o robada (MOV_JUGADA / MOV_ROBA)
+    uint8_t lado;     // LADO_IZQ / LADO_DER (mesa vacía se registra como derecha)
+    uint8_t tipo;     // TipoMovimiento
+};
+
+// Mesa de tamaño fijo: la línea crece hacia ambos lados desde el centro del arreglo
+template <int N>
+struct LineaMesa {
+    Ficha linea[2 * N];
+    int ini, fin;  // fichas en [ini, fin)
+
+    LineaMesa() : ini(N), fin(N) {}
+    void clear() { ini = fin = N; }
+    bool empty() const { return ini == fin; }
+    int size() const { return fin - ini; }
+    void push_front(const Ficha& f) { linea[--ini] = f; }
+    void push_back(const Ficha& f) { linea[fin++] = f; }
+    const Ficha& front() const { return linea[ini]; }
+    const Ficha& back() const { return linea[fin - 1]; }
+    const Ficha* begin() const { return linea + ini; }
+    const Ficha* end() const { return linea + fin; }
+};
+
+// Pozo de tamaño fijo con muestreo por intercambio: robar una ficha al azar es O(1)
+// (se elige una posición uniforme y se rellena el hueco con la última ficha)
+template <int N>
+class Pozo {
+private:
+    Ficha fichas[N];
+    int n;
+public:
+    Pozo() : n(0) {}
+    void clear() { n = 0; }
+    void add(const Ficha& f) { fichas[n++] = f; }
+    bool empty() const { return n == 0; }
+    int size() const { return n; }
+
+    template <class Gen>
+    Ficha draw(Gen& rng) {
+        uniform_int_distribution<int> dist(0, n - 1);
+        int k = dist(rng);
+        Ficha f = fichas[k];
+        fichas[k] = fichas[--n];
+        return f;
+    }
+};
+
+// Semilla de un flujo aleatorio independiente (splitmix64): cada ronda y cada uso
+// (reparto, robo) tiene su propio flujo, así una partida se reproduce con la semilla base
+inline uint64_t semillaFlujo(uint64_t base, uint64_t ronda, uint64_t flujo) {
+    uint64_t z = base + 0x9E3779B97F4A7C15ull * (ronda * 2 + flujo + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Generador splitmix64 de 8 bytes de estado: sembrarlo cada ronda es una asignación,
+// a diferencia de mt19937 (2.5 KB de estado que hay que regenerar en cada semilla)
+class FlujoAleatorio {
+private:
+    uint64_t estado;
+public:
+    typedef uint64_t result_type;
+    explicit FlujoAleatorio(uint64_t semilla = 0) : estado(semilla) {}
+    void seed(uint64_t semilla) { estado = semilla; }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~(result_type)0; }
+    result_type operator()() {
+        uint64_t z = (estado += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Aplica una jugada a la mesa orientando la ficha igual que playRound
+template <class R, class Mesa>
+Ficha aplicarJugada(Mesa& mesa, int id, int lado) {
+    Ficha f = R::ficha(id);
+    if (mesa.empty()) {
+        mesa.push_back(f);
+    } else if (lado == LADO_IZQ) {
+        int need = mesa.front().first();
+        if (f.second() != need) f.flip();
+        mesa.push_front(f);
+    } else {
+        int need = mesa.back().second();
+        if (f.first() != need) f.flip();
+        mesa.push_back(f);
+    }
+    return f;
+}
+
+// Mismo criterio que JuegoDomino::determineStarter: doble más alto, si no la ficha de más pips
+template <class R>
+int inicialPorManos(const typename R::Mascara* manos, int n) {
+    int starter = 0, bestDouble = -1, bestSum = -1;
+    for (int i = 0; i < n; ++i)
+        for (int id = 0; id < R::NUM_FICHAS; ++id) {
+            if (!R::tiene(manos[i], id)) continue;
+            const Ficha& f = R::ficha(id);
+            if (f.first() == f.second() && f.first() > bestDouble) { bestDouble = f.first(); starter = i; }
+        }
+    if (bestDouble != -1) return starter;
+    for (int i = 0; i < n; ++i)
+        for (int id = 0; id < R::NUM_FICHAS; ++id) {
+            if (!R::tiene(manos[i], id)) continue;
+            int s = R::ficha(id).pips();
+            if (s > bestSum) { bestSum = s; starter = i; }
+        }
+    return starter;
+}
+
+// Estado completo de una ronda en un punto del historial
+template <class R>
+struct EstadoDomino {
+    typename R::Mascara manos[R::MAX_JUGADORES];
+    typename R::Mascara pozo;  // fichas que no se repartieron ni se han robado
+    LineaMesa<R::NUM_FICHAS> mesa;
+    int turno;          // jugador que debe mover
+    int pasesSeguidos;
+    bool bloqueada;     // el siguiente registro debe ser BLOQUEO
+    bool terminada;
+};
+
+// Reproduce un historial guardado (texto o binario), valida cada movimiento y permite
+// saltar a cualquier índice usando estados de control cada INTERVALO movimientos.
+template <class R>
+class ReplayDomino {
+private:
+    typedef typename R::Mascara Mascara;
+    static const size_t INTERVALO = 8;
+    // cota de una ronda: cada ficha se roba y se juega a lo sumo una vez, entre dos jugadas hay
+    // menos de MAX_JUGADORES pases seguidos, y al final puede venir un BLOQUEO
+    static const uint32_t MAX_MOVIMIENTOS = 2 * R::NUM_FICHAS + R::MAX_JUGADORES * (R::NUM_FICHAS + 1) + 1;
+
+    vector<string> nombres;
+    vector<Mascara> manosIniciales;
+    vector<Movimiento> movs;
+    vector<EstadoDomino<R>> checkpoints;  // checkpoints[k] = estado tras k*INTERVALO movimientos
+    string error;
+
+    bool fallo(size_t idx, const string& msg) {
+        error = "movimiento " + to_string(idx + 1) + ": " + msg;
+        return false;
+    }
+
+    void estadoInicial(EstadoDomino<R>& e) const {
+        int n = (int)nombres.size();
+        e.pozo = Mascara();
+        for (int id = 0; id < R::NUM_FICHAS; ++id) e.pozo |= R::bit(id);
+        for (int i = 0; i < R::MAX_JUGADORES; ++i) {
+            e.manos[i] = i < n ? manosIniciales[i] : Mascara();
+            e.pozo &= ~e.manos[i];
+        }
+        e.mesa.clear();
+        e.turno = inicialPorManos<R>(e.manos, n);
+        e.pasesSeguidos = 0;
+        e.bloqueada = false;
+        e.terminada = false;
+    }
+
+    // Aplica m sobre e sin validar (el historial ya fue validado)
+    void avanzar(EstadoDomino<R>& e, const Movimiento& m) const {
+        int n = (int)nombres.size();
+        if (m.tipo == MOV_BLOQUEO) { e.terminada = true; return; }
+        if (m.tipo == MOV_ROBA) {
+            // robar no termina el turno
+            e.manos[m.jugador] |= R::bit(m.ficha);
+            e.pozo &= ~R::bit(m.ficha);
+            return;
+        }
+        if (m.tipo == MOV_PASA) {
+            e.pasesSeguidos++;
+        } else {
+            aplicarJugada<R>(e.mesa, m.ficha, m.lado);
+            e.manos[m.jugador] &= ~R::bit(m.ficha);
+            e.pasesSeguidos = 0;
+        }
+        if (e.manos[m.jugador] == Mascara()) { e.terminada = true; return; }
+        e.bloqueada = e.pasesSeguidos >= n;
+        if (!e.bloqueada && !e.mesa.empty()) {
+            Mascara jugables = R::conValor(e.mesa.front().first()) | R::conValor(e.mesa.back().second());
+            bool alguien = false;
+            for (int i = 0; i < n; ++i) if ((e.manos[i] & jugables) != Mascara()) alguien = true;
+            // con robo, mientras quede pozo alguien puede seguir robando
+            e.bloqueada = !alguien && (!R::ROBO || e.pozo == Mascara());
+        }
+        e.turno = (e.turno + 1) % n;
+    }
+
+    // Verifica que m sea legal en el estado e (mismas reglas que JuegoDomino::playRound)
+    bool validarMovimiento(const EstadoDomino<R>& e, const Movimiento& m, size_t idx) {
+        if (e.terminada) return fallo(idx, "la ronda ya había terminado");
+        if (m.tipo == MOV_BLOQUEO) {
+            if (!e.bloqueada) return fallo(idx, "BLOQUEO sin que la ronda esté bloqueada");
+            return true;
+        }
+        if (e.bloqueada) return fallo(idx, "la ronda debía terminar por bloqueo");
+        if (m.tipo != MOV_JUGADA && m.tipo != MOV_PASA && m.tipo != MOV_ROBA) return fallo(idx, "tipo de movimiento desconocido");
+        if (m.jugador != e.turno) return fallo(idx, "no es el turno de " + nombres[m.jugador]);
+        bool puedeJugar = e.mesa.empty() ||
+            (e.manos[m.jugador] & (R::conValor(e.mesa.front().first()) | R::conValor(e.mesa.back().second()))) != Mascara();
+        if (m.tipo == MOV_ROBA) {
+            if (!R::ROBO) return fallo(idx, "esta variante no permite robar");
+            if (m.ficha >= R::NUM_FICHAS || !R::tiene(e.pozo, m.ficha)) return fallo(idx, "la ficha robada no está en el pozo");
+            if (puedeJugar) return fallo(idx, nombres[m.jugador] + " roba teniendo jugada");
+            return true;
+        }
+        if (m.tipo == MOV_PASA) {
+            if (R::ROBO && !puedeJugar && e.pozo != Mascara()) return fallo(idx, nombres[m.jugador] + " debía robar del pozo");
+            return true;
+        }
+        if (m.ficha >= R::NUM_FICHAS) return fallo(idx, "ficha inexistente");
+        if (!R::tiene(e.manos[m.jugador], m.ficha)) return fallo(idx, nombres[m.jugador] + " no tiene esa ficha");
+        if (!e.mesa.empty()) {
+            int need = (m.lado == LADO_IZQ) ? e.mesa.front().first() : e.mesa.back().second();
+            if (!R::ficha(m.ficha).canConnect(need)) return fallo(idx, "la ficha no encaja en ese lado");
+        }
+        return true;
+    }
+
+    static bool parseFichas(const string& txt, vector<Ficha>& out) {
+        out.clear();
+        size_t pos = 0;
+        while ((pos = txt.find('[', pos)) != string::npos) {
+            int a, b;
+            if (sscanf(txt.c_str() + pos, "[%d|%d]", &a, &b) != 2) return false;
+            if (a < 0 || b < 0 || a > R::MAX_PIP || b > R::MAX_PIP) return false;
+            out.emplace_back(a, b);
+            ++pos;
+        }
+        return true;
+    }
+
+    // Separa "a | b | c" en tres campos
+    static bool separar(const string& linea, string& a, string& b, string& c) {
+        size_t p1 = linea.find(" | ");
+        if (p1 == string::npos) return false;
+        size_t p2 = linea.find(" | ", p1 + 3);
+        if (p2 == string::npos) return false;
+        a = linea.substr(0, p1);
+        b = linea.substr(p1 + 3, p2 - p1 - 3);
+        c = linea.substr(p2 + 3);
+        return true;
+    }
+
+    // Número de jugador escrito en el historial (desde 1); solo dígitos
+    static bool leerIndice(const string& t, int& i) {
+        if (t.empty() || t.size() > 3 || t.find_first_not_of("0123456789") != string::npos) return false;
+        i = atoi(t.c_str()) - 1;
+        return i >= 0;
+    }
+
+    // Separa "x | nombre": el nombre es lo último de la línea y puede contener " | "
+    static bool separarNombre(const string& t, string& x, string& nombre) {
+        size_t p = t.find(" | ");
+        if (p == string::npos) return false;
+        x = t.substr(0, p);
+        nombre = t.substr(p + 3);
+        return true;
+    }
+
+    static string mesaTexto(const LineaMesa<R::NUM_FICHAS>& mesa) {
+        string t;
+        for (const auto& f : mesa) t += f.str();
+        return t;
+    }
+
+    bool cargarTexto(const string& archivo) {
+        ifstream ifs(archivo);
+        if (!ifs.is_open()) { error = "no se pudo abrir " + archivo; return false; }
+        string linea, a, b, c, campo, nm;
+        vector<Ficha> fichas;
+        // el texto no guarda el lado: se deduce comparando con el tablero reproducido
+        LineaMesa<R::NUM_FICHAS> mesa;
+        string previo;
+        bool conReglas = false;
+        while (getline(ifs, linea)) {
+            int pip;
+            if (sscanf(linea.c_str(), "Variante: doble %d", &pip) == 1 && pip != R::MAX_PIP) {
+                error = "el historial es de otra variante (doble " + to_string(pip) + ")";
+                return false;
+            }
+            if (linea.compare(0, 8, "Reglas: ") == 0) {
+                if (linea.substr(8) != R::firma()) { error = "el historial es de otras reglas (" + linea.substr(8) + ")"; return false; }
+                conReglas = true;
+                continue;
+            }
+            if (linea.compare(0, 8, "Formato:") == 0 || !separar(linea, a, b, c)) continue;  // encabezado o línea vacía
+            // los jugadores se identifican por número; el nombre va al final y se toma tal cual,
+            // así dos jugadores con el mismo nombre o un nombre con " | " no se confunden
+            int j;
+            if (a == "MANO INICIAL") {
+                if (!leerIndice(b, j) || j != (int)nombres.size() || j >= R::MAX_JUGADORES ||
+                    !separarNombre(c, campo, nm) || !parseFichas(campo, fichas)) {
+                    error = "mano inicial inválida: " + linea;
+                    return false;
+                }
+                Mascara mano = Mascara();
+                for (const auto& f : fichas) mano |= R::bit(R::id(f));
+                nombres.push_back(nm);
+                manosIniciales.push_back(mano);
+                continue;
+            }
+            Movimiento m = {0, 0, LADO_DER, MOV_PASA};
+            if (a == "SYSTEM" && b == "BLOQUEO") {
+                m.tipo = MOV_BLOQUEO;
+            } else {
+                if (!leerIndice(a, j) || j >= (int)nombres.size()) { error = "jugador desconocido: " + a; return false; }
+                if (!separarNombre(c, campo, nm) || nm != nombres[j]) { error = "el nombre no coincide con el jugador " + a + ": " + linea; return false; }
+                m.jugador = (uint8_t)j;
+                c = campo;
+                if (b.compare(0, 5, "ROBA ") == 0) {
+                    if (!parseFichas(b, fichas) || fichas.size() != 1) { error = "ficha inválida: " + linea; return false; }
+                    m.tipo = MOV_ROBA;
+                    m.ficha = (uint8_t)R::id(fichas[0]);
+                } else if (b != "PASA") {
+                    if (!parseFichas(b, fichas) || fichas.size() != 1) { error = "ficha inválida: " + linea; return false; }
+                    m.tipo = MOV_JUGADA;
+                    m.ficha = (uint8_t)R::id(fichas[0]);
+                    string ft = fichas[0].str();
+                    m.lado = (!mesa.empty() && c == ft + previo) ? LADO_IZQ : LADO_DER;
+                    if (aplicarJugada<R>(mesa, m.ficha, m.lado).str() != ft) { error = "orientación inconsistente: " + linea; return false; }
+                    previo = mesaTexto(mesa);
+                }
+                if (c != previo) { error = "el tablero no coincide con la reproducción: " + linea; return false; }
+            }
+            movs.push_back(m);
+        }
+        if (!conReglas) { error = "el historial no indica sus reglas (versión anterior)"; return false; }
+        if (nombres.empty()) { error = "el historial no tiene manos iniciales"; return false; }
+        return true;
+    }
+
+    bool cargarBinario(const string& archivo) {
+        ifstream ifs(archivo, ios::binary);
+        if (!ifs.is_open()) { error = "no se pudo abrir " + archivo; return false; }
+        char magic[4];
+        uint32_t reglas[5] = {}, n = 0, m = 0;
+        ifs.read(magic, 4);
+        ifs.read((char*)reglas, sizeof reglas);
+        ifs.read((char*)&n, sizeof n);
+        if (!ifs || string(magic, 4) != "DOM2") { error = "formato binario inválido"; return false; }
+        string suyas = R::firma((int)reglas[0], (int)reglas[1], (int)reglas[2], reglas[3] != 0, reglas[4] != 0);
+        if (suyas != R::firma()) { error = "el historial es de otras reglas (" + suyas + ")"; return false; }
+        if (n > (uint32_t)R::MAX_JUGADORES) { error = "formato binario inválido"; return false; }
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t len = 0, cuantas = 0;
+            ifs.read((char*)&len, sizeof len);
+            if (!ifs || len > 4096) { error = "formato binario inválido"; return false; }
+            string nm(len, '\0');
+            ifs.read(&nm[0], len);
+            ifs.read((char*)&cuantas, sizeof cuantas);
+            if (!ifs || cuantas > (uint32_t)R::NUM_FICHAS) { error = "formato binario inválido"; return false; }
+            Mascara mano = Mascara();
+            for (uint32_t k = 0; k < cuantas; ++k) {
+                uint8_t id = 0;
+                ifs.read((char*)&id, 1);
+                if (id >= R::NUM_FICHAS) { error = "ficha inexistente en una mano"; return false; }
+                mano |= R::bit(id);
+            }
+            nombres.push_back(nm);
+            manosIniciales.push_back(mano);
+        }
+        ifs.read((char*)&m, sizeof m);
+        if (!ifs) { error = "formato binario inválido"; return false; }
+        // m viene del archivo: se acota antes de reservar por la ronda más larga posible y por lo que queda
+        streamoff pos = ifs.tellg();
+        ifs.seekg(0, ios::end);
+        streamoff resto = ifs.tellg() - pos;
+        ifs.seekg(pos);
+        if (m > MAX_MOVIMIENTOS || (streamoff)m * (streamoff)sizeof(Movimiento) > resto) {
+            error = "historial binario truncado";
+            return false;
+        }
+        movs.resize(m);
+        if (m) ifs.read((char*)movs.data(), m * sizeof(Movimiento));
+        if (!ifs) { error = "historial binario truncado"; return false; }
+        return true;
+    }
+
+public:
+    // Carga un historial; detecta el formato binario por su encabezado ("DOMH" es el binario anterior,
+    // sin reglas, y se rechaza)
+    bool cargar(const string& archivo) {
+        nombres.clear(); manosIniciales.clear(); movs.clear(); checkpoints.clear(); error.clear();
+        ifstream ifs(archivo, ios::binary);
+        char magic[4] = {0};
+        ifs.read(magic, 4);
+        ifs.close();
+        if (string(magic, 4) == "DOMH") { error = "el historial no indica sus reglas (versión anterior)"; return false; }
+        return string(magic, 4) == "DOM2" ? cargarBinario(archivo) : cargarTexto(archivo);
+    }
+
+    // Valida la legalidad de toda la ronda y construye los estados de control
+    bool validar() {
+        checkpoints.clear();
+        int n = (int)nombres.size();
+        if (n < R::MIN_JUGADORES || n > R::MAX_JUGADORES) { error = "cantidad de jugadores inválida"; return false; }
+        Mascara todas = Mascara();
+        for (int i = 0; i < n; ++i) {
+            if ((todas & manosIniciales[i]) != Mascara()) { error = "una ficha aparece en dos manos"; return false; }
+            todas |= manosIniciales[i];
+        }
+        EstadoDomino<R> e;
+        estadoInicial(e);
+        for (size_t k = 0; k < movs.size(); ++k) {
+            if (k % INTERVALO == 0) checkpoints.push_back(e);
+            if (movs[k].jugador >= n) return fallo(k, "jugador inexistente");
+            if (!validarMovimiento(e, movs[k], k)) return false;
+            avanzar(e, movs[k]);
+        }
+        if (movs.size() % INTERVALO == 0) checkpoints.push_back(e);
+        if (!e.terminada) { error = "historial incompleto: la ronda no terminó"; return false; }
+        return true;
+    }
+
+    // Estado tras los primeros idx movimientos: estado de control más cercano + a lo sumo INTERVALO-1 pasos
+    bool irA(size_t idx, EstadoDomino<R>& out) const {
+        if (idx > movs.size() || checkpoints.empty()) return false;
+        out = checkpoints[idx / INTERVALO];
+        for (size_t k = idx / INTERVALO * INTERVALO; k < idx; ++k) avanzar(out, movs[k]);
+        return true;
+    }
+
+    size_t numMovimientos() const { return movs.size(); }
+    int numJugadores() const { return (int)nombres.size(); }
+    const string& nombre(int i) const { return nombres[i]; }
+    const Movimiento& movimiento(size_t i) const { return movs[i]; }
+    const string& mensajeError() const { return error; }
+};
+
+
+// Extrae el índice del bit más bajo de la máscara y lo borra
+inline int extraerBit(uint32_t& m) { int i = __builtin_ctz(m); m &= m - 1; return i; }
+inline int extraerBit(uint64_t& m) { int i = __builtin_ctzll(m); m &= m - 1; return i; }
+template <size_t N> int extraerBit(bitset<N>& m) { int i = (int)m._Find_first(); m.reset(i); return i; }
+
+// Solucionador exacto de finales con información perfecta (todas las manos visibles, pozo agotado).
+// Cada jugador con jugada debe jugar; sin jugada pasa. La ronda termina cuando alguien se queda
+// sin fichas o nadie puede jugar (gana el lado con menos pips, como blockedWinner).
+// Puntos del ganador = pips que quedan en manos de los demás lados; cada lado perdedor pierde
+// los pips que conserva. Cada lado maximiza su propio resultado (max^n; con 2 lados es minimax).
+// Los estados se memorizan por (manos, extremos ordenados, turno).
+template <class R>
+class SolverFinal {
+public:
+    typedef typename R::Mascara Mascara;
+    static const int MAX_LADOS = R::EQUIPOS ? 2 : R::MAX_JUGADORES;
+
+    struct Resultado {
+        int ganador;       // jugador ganador (por parejas: 0 o 1 = pareja 1-3 o 2-4)
+        int margen;        // pips de los perdedores que suma el ganador
+        int ficha, lado;   // mejor jugada del jugador en turno (ficha = -1 si debe pasar)
+    };
+
+private:
+    struct Clave {
+        Mascara manos[R::MAX_JUGADORES];
+        int8_t izq, der, turno;
+        bool operator==(const Clave& o) const {
+            if (izq != o.izq || der != o.der || turno != o.turno) return false;
+            for (int i = 0; i < R::MAX_JUGADORES; ++i) if (manos[i] != o.manos[i]) return false;
+            return true;
+        }
+    };
+    struct HashClave {
+        size_t operator()(const Clave& c) const {
+            uint64_t h = (uint64_t)(uint8_t)c.izq | (uint64_t)(uint8_t)c.der << 8 | (uint64_t)(uint8_t)c.turno << 16;
+            for (int i = 0; i < R::MAX_JUGADORES; ++i)
+                h = (h ^ hash<Mascara>()(c.manos[i])) * 0x9E3779B97F4A7C15ull;
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+    // resultado memorizado: lado ganador y pips que conserva cada lado al terminar
+    struct Valor {
+        int8_t ganador;
+        int16_t pips[MAX_LADOS];
+        int pago(int lado) const {
+            if (lado != ganador) return -pips[lado];
+            int puntos = 0;
+            for (int k = 0; k < MAX_LADOS; ++k) if (k != ganador) puntos += pips[k];
+            return puntos;
+        }
+        // preferencia del lado: su pago y, en empate, un orden total fijo sobre los resultados,
+        // para que la elección no dependa del orden de los extremos (que se canonicalizan)
+        bool mejorQue(const Valor& o, int lado) const {
+            if (pago(lado) != o.pago(lado)) return pago(lado) > o.pago(lado);
+            if (ganador != o.ganador) return ganador < o.ganador;
+            for (int k = 0; k < MAX_LADOS; ++k) if (pips[k] != o.pips[k]) return pips[k] < o.pips[k];
+            return false;
+        }
+    };
+
+    int n;
+    unordered_map<Clave, Valor, HashClave> memo;
+    size_t consultas, aciertos;
+
+    int lado(int jugador) const { return R::EQUIPOS ? jugador % 2 : jugador; }
+    int lados() const { return R::EQUIPOS ? 2 : n; }
+
+    static int pipsMano(Mascara m) {
+        int s = 0;
+        while (m != Mascara()) s += R::ficha(extraerBit(m)).pips();
+        return s;
+    }
+
+    Mascara jugables(int izq, int der) const { return R::conValor(izq) | R::conValor(der); }
+
+    bool nadiePuede(const Clave& c) const {
+        Mascara j = jugables(c.izq, c.der);
+        for (int i = 0; i < n; ++i) if ((c.manos[i] & j) != Mascara()) return false;
+        return true;
+    }
+
+    Valor terminal(const Clave& c, int ganadorJugador) const {
+        Valor v;
+        for (int k = 0; k < MAX_LADOS; ++k) v.pips[k] = 0;
+        for (int i = 0; i < n; ++i) v.pips[lado(i)] += (int16_t)pipsMano(c.manos[i]);
+        if (ganadorJugador >= 0) {
+            v.ganador = (int8_t)lado(ganadorJugador);
+        } else {
+            // bloqueo: menor pips, empate para el lado de menor índice
+            v.ganador = 0;
+            for (int k = 1; k < lados(); ++k) if (v.pips[k] < v.pips[v.ganador]) v.ganador = (int8_t)k;
+        }
+        return v;
+    }
+
+    // Estado tras colocar la ficha id en el lado indicado
+    Clave hijo(const Clave& c, int id, int lad) const {
+        Clave h = c;
+        const Ficha& f = R::ficha(id);
+        int need = lad == LADO_IZQ ? c.izq : c.der;
+        int otro = f.first() == need ? f.second() : f.first();
+        if (lad == LADO_IZQ) h.izq = (int8_t)otro; else h.der = (int8_t)otro;
+        if (h.izq > h.der) swap(h.izq, h.der);  // forma canónica: los extremos no tienen orden
+        h.manos[c.turno] &= ~R::bit(id);
+        h.turno = (int8_t)((c.turno + 1) % n);
+        return h;
+    }
+
+    // Valor del estado c (el jugador en turno tiene jugada o pasa); evalúa terminales al aplicar la jugada
+    Valor resolver(Clave c) {
+        if (c.izq > c.der) swap(c.izq, c.der);
+        // pases forzados: avanzar hasta quien pueda jugar (existe porque la ronda no está bloqueada)
+        Mascara j = jugables(c.izq, c.der);
+        while ((c.manos[c.turno] & j) == Mascara()) c.turno = (int8_t)((c.turno + 1) % n);
+
+        ++consultas;
+        auto it = memo.find(c);
+        if (it != memo.end()) { ++aciertos; return it->second; }
+
+        Valor mejor = Valor();
+        bool hay = false;
+        int yo = lado(c.turno);
+        Mascara opciones = c.manos[c.turno] & j;
+        while (opciones != Mascara()) {
+            int id = extraerBit(opciones);
+            const Ficha& f = R::ficha(id);
+            for (int lad = LADO_IZQ; lad <= LADO_DER; ++lad) {
+                int need = lad == LADO_IZQ ? c.izq : c.der;
+                if (!f.canConnect(need)) continue;
+                if (lad == LADO_DER && c.izq == c.der) continue;  // mismo extremo: jugada repetida
+                Valor v = evaluar(c, id, lad);
+                if (!hay || v.mejorQue(mejor, yo)) { mejor = v; hay = true; }
+            }
+        }
+        memo.emplace(c, mejor);
+        return mejor;
+    }
+
+    Valor evaluar(const Clave& c, int id, int lad) {
+        Clave h = hijo(c, id, lad);
+        if (h.manos[c.turno] == Mascara()) return terminal(h, c.turno);
+        if (nadiePuede(h)) return terminal(h, -1);
+        return resolver(h);
+    }
+
+public:
+    SolverFinal() : n(0), consultas(0), aciertos(0) {}
+
+    // manos[0..nJugadores), extremos de la mesa (no vacía) y jugador en turno
+    Resultado resolver(const Mascara* manos, int nJugadores, int izq, int der, int turno) {
+        n = nJugadores;
+        memo.clear();
+        consultas = aciertos = 0;
+        Clave c;
+        for (int i = 0; i < R::MAX_JUGADORES; ++i) c.manos[i] = i < n ? manos[i] : Mascara();
+        c.izq = (int8_t)izq; c.der = (int8_t)der; c.turno = (int8_t)turno;
+
+        Resultado res = {0, 0, -1, LADO_DER};
+        Valor v = Valor();
+        for (int i = 0; i < n; ++i) if (manos[i] == Mascara()) { v = terminal(c, i); res.ganador = v.ganador; res.margen = v.pago(v.ganador); return res; }
+        if (nadiePuede(c)) {
+            v = terminal(c, -1);
+        } else if ((manos[turno] & jugables(izq, der)) == Mascara()) {
+            v = resolver(c);  // el jugador en turno pasa
+        } else {
+            // raíz: se repite la búsqueda de la mejor jugada para poder informarla
+            int yo = lado(turno);
+            bool hay = false;
+            Mascara opciones = manos[turno] & jugables(izq, der);
+            while (opciones != Mascara()) {
+                int id = extraerBit(opciones);
+                const Ficha& f = R::ficha(id);
+                for (int lad = LADO_IZQ; lad <= LADO_DER; ++lad) {
+                    if (!f.canConnect(lad == LADO_IZQ ? izq : der)) continue;
+                    if (lad == LADO_DER && izq == der) continue;
+                    Valor w = evaluar(c, id, lad);
+                    if (!hay || w.mejorQue(v, yo)) { v = w; hay = true; res.ficha = id; res.lado = lad; }
+                }
+            }
+        }
+        res.ganador = v.ganador;
+        res.margen = v.pago(v.ganador);
+        return res;
+    }
+
+    size_t estados() const { return memo.size(); }
+    size_t numConsultas() const { return consultas; }
+    size_t numAciertos() const { return aciertos; }
+    double tasaAciertos() const { return consultas ? (double)aciertos / consultas : 0.0; }
+};
+
+
+#ifdef DOMINO_ESTADISTICAS
+// Compilar con -DDOMINO_ESTADISTICAS para medir tiempos por fase y contar eventos de juego
+// (ver --estadisticas). Sin la macro, DOMINO_CRONO y DOMINO_CONTAR no generan código.
+enum FaseDomino { FASE_REPARTO, FASE_JUGADAS, FASE_BLOQUEO, FASE_HISTORIAL, NUM_FASES };
+static const char* const NOMBRE_FASE[NUM_FASES] = { "reparto", "jugadas", "bloqueo", "historial" };
+
+struct EstadisticasDomino {
+    static const int CUBETAS = 16;   // histograma de márgenes en cubetas de 10 pips (la última acumula el resto)
+    static const int MUESTREO = 16;  // se cronometra una de cada MUESTREO llamadas de cada fase
+
+    uint64_t faseNs[NUM_FASES];       // tiempo de las llamadas cronometradas
+    uint64_t faseLlamadas[NUM_FASES];
+    uint64_t faseMuestras[NUM_FASES]; // llamadas cronometradas
+    uint64_t rondas, turnos, jugadas, pases, robos, bloqueos, domino;
+    uint64_t rondaNs, rondaMinNs, rondaMaxNs;
+    uint64_t sumaMargen;
+    int margenMin, margenMax;
+    uint64_t margenes[CUBETAS];
+
+    EstadisticasDomino() { reiniciar(); }
+
+    void reiniciar() {
+        for (int f = 0; f < NUM_FASES; ++f) faseNs[f] = faseLlamadas[f] = faseMuestras[f] = 0;
+        rondas = turnos = jugadas = pases = robos = bloqueos = domino = 0;
+        rondaNs = rondaMaxNs = 0;
+        rondaMinNs = numeric_limits<uint64_t>::max();
+        sumaMargen = 0;
+        margenMin = numeric_limits<int>::max();
+        margenMax = 0;
+        for (int c = 0; c < CUBETAS; ++c) margenes[c] = 0;
+    }
+
+    void finRonda(uint64_t ns, int margen, bool porBloqueo) {
+        ++rondas;
+        if (porBloqueo) ++bloqueos; else ++domino;
+        rondaNs += ns;
+        rondaMinNs = min(rondaMinNs, ns);
+        rondaMaxNs = max(rondaMaxNs, ns);
+        sumaMargen += margen;
+        margenMin = min(margenMin, margen);
+        margenMax = max(margenMax, margen);
+        ++margenes[min(margen / 10, CUBETAS - 1)];
+    }
+
+    // Lo que mide un intervalo vacío (una lectura del reloj): se descuenta de cada muestra
+    static double costoRelojNs() {
+        static const double costo = [] {
+            const int N = 2000;
+            uint64_t total = 0;
+            for (int i = 0; i < N; ++i) {
+                auto t0 = chrono::steady_clock::now();
+                total += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+            }
+            return (double)total / N;
+        }();
+        return costo;
+    }
+
+    // Tiempo estimado de la fase: lo cronometrado, sin el costo del reloj, escalado a todas sus llamadas
+    uint64_t faseEstimadaNs(int f) const {
+        if (!faseMuestras[f]) return 0;
+        double neto = max(0.0, (double)faseNs[f] - costoRelojNs() * faseMuestras[f]);
+        return (uint64_t)(neto * faseLlamadas[f] / faseMuestras[f]);
+    }
+
+    // Informe JSON de una variante (objeto sin salto de línea final)
+    void exportarJSON(ostream& os, const char* variante, int jugadores) const {
+        os << "{\"variante\": \"" << variante << "\", \"jugadores\": " << jugadores
+           << ", \"rondas\": " << rondas << ", \"turnos\": " << turnos << ", \"jugadas\": " << jugadas
+           << ", \"pases\": " << pases << ", \"robos\": " << robos << ", \"bloqueos\": " << bloqueos
+           << ", \"domino\": " << domino << ",\n";
+        os << "   \"ronda_ns\": {\"total\": " << rondaNs << ", \"promedio\": " << (rondas ? rondaNs / rondas : 0)
+           << ", \"min\": " << (rondas ? rondaMinNs : 0) << ", \"max\": " << rondaMaxNs << "},\n";
+        os << "   \"fases\": {";
+        for (int f = 0; f < NUM_FASES; ++f)
+            os << (f ? ", " : "") << "\"" << NOMBRE_FASE[f] << "\": {\"ns\": " << faseEstimadaNs(f)
+               << ", \"llamadas\": " << faseLlamadas[f] << ", \"muestras\": " << faseMuestras[f] << "}";
+        os << "},\n";
+        os << "   \"margen\": {\"promedio\": " << (rondas ? (double)sumaMargen / rondas : 0.0)
+           << ", \"min\": " << (rondas ? margenMin : 0) << ", \"max\": " << margenMax << ", \"histograma_10\": [";
+        for (int c = 0; c < CUBETAS; ++c) os << (c ? ", " : "") << margenes[c];
+        os << "]}}";
+    }
+};
+
+// Suma al acumulador de la fase el tiempo del ámbito donde se declara. Leer el reloj cuesta
+// tanto como las funciones cortas que se miden (canPlay, addHistory), así que solo se cronometra
+// una de cada MUESTREO llamadas; las demás solo se cuentan (ver faseEstimadaNs)
+class CronoFase {
+    EstadisticasDomino& est;
+    FaseDomino fase;
+    bool medir;
+    chrono::steady_clock::time_point t0;
+public:
+    CronoFase(EstadisticasDomino& e, FaseDomino f)
+        : est(e), fase(f), medir(e.faseLlamadas[f]++ % EstadisticasDomino::MUESTREO == 0) {
+        if (medir) t0 = chrono::steady_clock::now();
+    }
+    ~CronoFase() {
+        if (!medir) return;
+        est.faseNs[fase] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+        ++est.faseMuestras[fase];
+    }
+};
+
+#define DOMINO_CONCAT2(a, b) a##b
+#define DOMINO_CONCAT(a, b) DOMINO_CONCAT2(a, b)
+#define DOMINO_CRONO(fase) CronoFase DOMINO_CONCAT(crono_, __LINE__)(stats, fase)
+#define DOMINO_CONTAR(campo, n) (stats.campo += (n))
+#else
+#define DOMINO_CRONO(fase) ((void)0)
+#define DOMINO_CONTAR(campo, n) ((void)0)
+#endif
+
+// Máscara de fichas <-> bytes little-endian (bit k = ficha con id k), igual para todos los tamaños
+template <class M>
+void mascaraABytes(M m, uint8_t* out, int nb) {
+    for (int i = 0; i < nb; ++i) { out[i] = (uint8_t)(m & 0xFF); m >>= 8; }
+}
+template <size_t N>
+void mascaraABytes(const bitset<N>& m, uint8_t* out, int nb) {
+#if defined(__GLIBCXX__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(out, &m, nb);  // libstdc++ guarda los bits en palabras desde el bit 0
+#else
+    memset(out, 0, nb);
+    for (size_t i = m._Find_first(); i < N; i = m._Find_next(i)) out[i >> 3] |= (uint8_t)(1u << (i & 7));
+#endif
+}
+template <class M>
+void bytesAMascara(const uint8_t* in, int nb, M& m) {
+    m = 0;
+    for (int i = nb - 1; i >= 0; --i) { m <<= 8; m |= in[i]; }
+}
+template <size_t N>
+void bytesAMascara(const uint8_t* in, int nb, bitset<N>& m) {
+    m.reset();
+    for (int i = 0; i < nb; ++i)
+        for (int b = 0; b < 8; ++b) if (in[i] >> b & 1) m.set(i * 8 + b);
+}
+
+// Exporta partidas automáticas para entrenar estrategias: un registro por decisión (turno en
+// que el jugador tenía al menos una jugada; los pases forzados no se registran).
+// Formato "DOMD" (little-endian):
+//   cabecera: "DOMD", versión, doble, fichas, jugadores, parejas, robo, bytes por máscara,
+//             semilla (u64), rondas (u64), decisiones (u64)
+//   bloques:  n (u32) y luego cada columna contigua con n valores:
+//             ronda u32 | jugador u8 | izq u8 | der u8 (255 = mesa vacía) | mano, legalIzq,
+//             legalDer (máscaras) | ficha u8 | lado u8 | gano u8 | puntos i16
+//   fin:      bloque con n = 0
+// puntos es el resultado de la ronda para el lado del jugador: lo que suma si gana (pips de los
+// perdedores) o sus propios pips en negativo si pierde. Las decisiones de la ronda en curso se
+// guardan aparte hasta conocer el resultado; un hilo escritor vacía cada bloque lleno mientras
+// el simulador llena el otro, así la exportación no frena la simulación.
+template <class R>
+class DatasetDomino {
+public:
+    static const int BYTES_MASCARA = (R::NUM_FICHAS + 7) / 8;
+    static const uint32_t VERSION = 1;
+    static const size_t BLOQUE = 1 << 16;
+    static const size_t CABECERA = 4 + 7 * 4 + 3 * 8;
+
+private:
+    typedef typename R::Mascara Mascara;
+
+    struct Decision {
+        Mascara mano, legalIzq, legalDer;
+        uint8_t jugador, izq, der, ficha, lado;
+    };
+
+    struct Bloque {
+        size_t n;
+        vector<uint32_t> ronda;
+        vector<uint8_t> jugador, izq, der, ficha, lado, gano;
+        vector<int16_t> puntos;
+        vector<uint8_t> mano, legalIzq, legalDer;
+
+        Bloque() : n(0), ronda(BLOQUE), jugador(BLOQUE), izq(BLOQUE), der(BLOQUE), ficha(BLOQUE), lado(BLOQUE),
+                   gano(BLOQUE), puntos(BLOQUE), mano(BLOQUE * BYTES_MASCARA), legalIzq(BLOQUE * BYTES_MASCARA),
+                   legalDer(BLOQUE * BYTES_MASCARA) {}
+
+        void escribir(FILE* f) const {
+            uint32_t m = (uint32_t)n;
+            fwrite(&m, 4, 1, f);
+            fwrite(ronda.data(), 4, n, f);
+            fwrite(jugador.data(), 1, n, f);
+            fwrite(izq.data(), 1, n, f);
+            fwrite(der.data(), 1, n, f);
+            fwrite(mano.data(), BYTES_MASCARA, n, f);
+            fwrite(legalIzq.data(), BYTES_MASCARA, n, f);
+            fwrite(legalDer.data(), BYTES_MASCARA, n, f);
+            fwrite(ficha.data(), 1, n, f);
+            fwrite(lado.data(), 1, n, f);
+            fwrite(gano.data(), 1, n, f);
+            fwrite(puntos.data(), 2, n, f);
+        }
+    };
+
+    FILE* archivo;
+    Decision pendientes[R::NUM_FICHAS];  // cada decisión coloca una ficha: no hay más por ronda
+    int numPendientes;
+    uint64_t rondas, decisiones;
+
+    // doble búfer compartido con el hilo escritor
+    Bloque bloques[2];
+    Bloque* actual;
+    Bloque* enEscritura;  // nullptr si el escritor está libre
+    mutex mtx;
+    condition_variable hayBloque, bloqueLibre;
+    bool detener;
+    thread escritor;
+
+    void bucleEscritor() {
+        unique_lock<mutex> lk(mtx);
+        while (true) {
+            hayBloque.wait(lk, [this] { return detener || enEscritura; });
+            if (!enEscritura) break;
+            Bloque* b = enEscritura;
+            lk.unlock();
+            b->escribir(archivo);
+            lk.lock();
+            enEscritura = nullptr;
+            bloqueLibre.notify_one();
+        }
+    }
+
+    // entrega el bloque actual al escritor y sigue con el otro (espera solo si el disco va atrasado)
+    void entregar() {
+        unique_lock<mutex> lk(mtx);
+        bloqueLibre.wait(lk, [this] { return !enEscritura; });
+        enEscritura = actual;
+        actual = actual == &bloques[0] ? &bloques[1] : &bloques[0];
+        actual->n = 0;
+        hayBloque.notify_one();
+    }
+
+public:
+    DatasetDomino() : archivo(nullptr), numPendientes(0), rondas(0), decisiones(0),
+                      actual(&bloques[0]), enEscritura(nullptr), detener(false) {}
+    ~DatasetDomino() { cerrar(); }
+
+    bool abrir(const string& nombre, int jugadores, uint64_t semilla) {
+        archivo = fopen(nombre.c_str(), "wb");
+        if (!archivo) return false;
+        setvbuf(archivo, nullptr, _IOFBF, 1 << 20);
+        uint32_t cab[7] = { VERSION, (uint32_t)R::MAX_PIP, (uint32_t)R::NUM_FICHAS, (uint32_t)jugadores,
+                            (uint32_t)R::EQUIPOS, (uint32_t)R::ROBO, (uint32_t)BYTES_MASCARA };
+        uint64_t cuentas[3] = { semilla, 0, 0 };  // rondas y decisiones se completan al cerrar
+        fwrite("DOMD", 4, 1, archivo);
+        fwrite(cab, 4, 7, archivo);
+        fwrite(cuentas, 8, 3, archivo);
+        escritor = thread(&DatasetDomino::bucleEscritor, this);
+        return true;
+    }
+
+    // izq/der: extremos de la mesa (-1 si está vacía)
+    void decision(int jugador, int izq, int der, const Mascara& mano, const Mascara& legalIzq,
+                  const Mascara& legalDer, int ficha, int lado) {
+        Decision& d = pendientes[numPendientes++];
+        d.mano = mano;
+        d.legalIzq = legalIzq;
+        d.legalDer = legalDer;
+        d.jugador = (uint8_t)jugador;
+        d.izq = (uint8_t)(izq < 0 ? 255 : izq);
+        d.der = (uint8_t)(der < 0 ? 255 : der);
+        d.ficha = (uint8_t)ficha;
+        d.lado = (uint8_t)lado;
+    }
+
+    // cierra la ronda: ganador es el lado ganador y pips[l] lo que le queda en mano a cada lado
+    void finRonda(int ganador, const int* pips, int lados) {
+        int margen = 0;
+        for (int l = 0; l < lados; ++l) if (l != ganador) margen += pips[l];
+        for (int k = 0; k < numPendientes; ++k) {
+            const Decision& d = pendientes[k];
+            int lado = R::EQUIPOS ? d.jugador % 2 : d.jugador;
+            Bloque& b = *actual;
+            size_t i = b.n;
+            b.ronda[i] = (uint32_t)rondas;
+            b.jugador[i] = d.jugador;
+            b.izq[i] = d.izq;
+            b.der[i] = d.der;
+            mascaraABytes(d.mano, &b.mano[i * BYTES_MASCARA], BYTES_MASCARA);
+            mascaraABytes(d.legalIzq, &b.legalIzq[i * BYTES_MASCARA], BYTES_MASCARA);
+            mascaraABytes(d.legalDer, &b.legalDer[i * BYTES_MASCARA], BYTES_MASCARA);
+            b.ficha[i] = d.ficha;
+            b.lado[i] = d.lado;
+            b.gano[i] = lado == ganador;
+            b.puntos[i] = (int16_t)(lado == ganador ? margen : -pips[lado]);
+            if (++b.n == BLOQUE) entregar();
+        }
+        decisiones += numPendientes;
+        numPendientes = 0;
+        ++rondas;
+    }
+
+    // escribe lo que quede, el bloque final y las cuentas de la cabecera
+    void cerrar() {
+        if (!archivo) return;
+        if (actual->n) entregar();
+        {
+            lock_guard<mutex> lk(mtx);
+            detener = true;
+            hayBloque.notify_one();
+        }
+        if (escritor.joinable()) escritor.join();
+        uint32_t fin = 0;
+        fwrite(&fin, 4, 1, archivo);
+        uint64_t cuentas[2] = { rondas, decisiones };
+        fseek(archivo, CABECERA - 16, SEEK_SET);
+        fwrite(cuentas, 8, 2, archivo);
+        fclose(archivo);
+        archivo = nullptr;
+    }
+
+    uint64_t numRondas() const { return rondas; }
+    uint64_t numDecisiones() const { return decisiones + numPendientes; }
+};
+
+template <class R>
+class JuegoDomino {
+private:
+    typedef typename R::Mascara Mascara;
+
+    // tamaños fijos: la ronda no reserva memoria dinámica una vez configurados los jugadores
+    Pozo<R::NUM_FICHAS> boneyard;  // antes de repartir contiene el juego completo
+    LineaMesa<R::NUM_FICHAS> table;
+    vector<Jugador<R>*> players;
+    int currentIdx;
+    int passesInRow;
+    // flujos aleatorios reproducibles: ronda k usa semillaFlujo(baseSeed, k, 0) para repartir
+    // y semillaFlujo(baseSeed, k, 1) para robar
+    uint64_t baseSeed;
+    uint64_t roundNumber;
+    FlujoAleatorio dealRng;
+    FlujoAleatorio drawRng;
+
+    // historial compacto: solo movimientos codificados; los tableros se reconstruyen al reproducir.
+    // Se reserva una sola vez para el peor caso (cada ficha precedida de pases de todos los demás)
+    vector<Movimiento> historial;
+    vector<string> histNames;  // nombres de los jugadores de la ronda registrada
+    Mascara histManos[R::MAX_JUGADORES]; // manos iniciales para poder reproducir la ronda
+    bool histInteractivo;  // el historial es de una ronda jugada en consola (solo esas se guardan)
+
+#ifdef DOMINO_ESTADISTICAS
+    mutable EstadisticasDomino stats;  // mutable: también se mide desde métodos const
+    chrono::steady_clock::time_point inicioRonda;
+#endif
+
+    // crear el juego completo (28 fichas en doble seis) directamente en el pozo
+    void createDeck() {
+        boneyard.clear();
+        for (int i = 0; i <= R::MAX_PIP; ++i)
+            for (int j = i; j <= R::MAX_PIP; ++j)
+                boneyard.add(Ficha(i, j));
+    }
+
+    // repartir R::MANO fichas por jugador sacándolas al azar del pozo; lo que queda es el pozo de robo
+    void dealHands() {
+        for (auto p : players) p->clearHand();
+
+        int per = R::MANO;
+        for (int r = 0; r < per; ++r) {
+            for (auto p : players) {
+                if (!boneyard.empty()) {
+                    p->receive(boneyard.draw(dealRng));
+                }
+            }
+        }
+    }
+
+    // con robo: el jugador actual roba hasta tener jugada o vaciar el pozo; devuelve cuántas robó
+    int drawUntilPlayable() {
+        Jugador<R>* cur = players[currentIdx];
+        int L = table.front().first();
+        int R_ = table.back().second();
+        int robadas = 0;
+        while (!boneyard.empty() && !cur->hasPlayable(L, R_)) {
+            Ficha f = boneyard.draw(drawRng);
+            cur->receive(f);
+            addHistory(currentIdx, MOV_ROBA, R::id(f));
+            DOMINO_CONTAR(robos, 1);
+            ++robadas;
+        }
+        return robadas;
+    }
+
+    //
+    int determineStarter() {
+        int starter = 0;
+        int bestDouble = -1;
+        for (int i = 0; i < (int)players.size(); ++i) {
+            for (int k = 0; k < players[i]->handSize(); ++k) {
+                const Ficha& f = players[i]->tileAt(k);
+                if (f.first() == f.second()) {
+                    if (f.first() > bestDouble) {
+                        bestDouble = f.first();
+                        starter = i;
+                    }
+                }
+            }
+        }
+        if (bestDouble != -1) return starter;
+
+        int bestSum = -1;
+        for (int i = 0; i < (int)players.size(); ++i) {
+            for (int k = 0; k < players[i]->handSize(); ++k) {
+                int s = players[i]->tileAt(k).pips();
+                if (s > bestSum) { bestSum = s; starter = i; }
+            }
+        }
+        return starter;
+    }
+
+    void showTable() const {
+        cout << "\n--- MESA ---\n";
+        if (table.empty()) cout << "(vacía)\n";
+        else {
+            for (const auto& f : table) { f.print(); cout << " "; }
+            cout << "\nExtremos: " << table.front().first() << " ... " << table.back().second() << "\n";
+        }
+        if (R::ROBO) cout << "Pozo: " << boneyard.size() << " fichas\n";
+        cout << "-------------\n";
+    }
+
+    // el jugador tiene alguna ficha que encaje (con la mesa vacía, cualquiera)
+    bool canPlay(const Jugador<R>* p) const {
+        DOMINO_CRONO(FASE_JUGADAS);
+        return table.empty() || p->hasPlayable(table.front().first(), table.back().second());
+    }
+
+    bool isBlocked() const {
+        if (table.empty()) return false;
+        int L = table.front().first();
+        int R_ = table.back().second();
+        for (auto p : players) if (p->hasPlayable(L, R_)) return false;
+        return true;
+    }
+
+    void addHistory(int jugador, TipoMovimiento tipo, int id = 0, int lado = LADO_DER) {
+        DOMINO_CRONO(FASE_HISTORIAL);
+        Movimiento m;
+        m.jugador = (uint8_t)jugador;
+        m.ficha = (uint8_t)id;
+        m.lado = (uint8_t)lado;
+        m.tipo = tipo;
+        historial.push_back(m);
+    }
+
+    // Guarda historial en archivo "<base>.txt" (los tableros se generan reproduciendo el registro)
+    // y su equivalente binario "<base>.bin"
+    void saveHistoryToFile(const string& base = "historial_domino") const {
+        DOMINO_CRONO(FASE_HISTORIAL);
+        saveHistoryBinary(base + ".bin");
+        const string filename = base + ".txt";
+        ofstream ofs(filename);
+        if (!ofs.is_open()) {
+            cerr << "Error: no se pudo escribir el archivo de historial.\n";
+            return;
+        }
+        ofs << "HISTORIAL DE MOVIMIENTOS - Dominó\n";
+        ofs << "Formato: Nº jugador | Ficha (o PASA) | Estado del tablero después del movimiento | Nombre\n";
+        ofs << "Variante: doble " << R::MAX_PIP << "\n";
+        ofs << "Reglas: " << R::firma() << "\n";
+        for (size_t i = 0; i < histNames.size(); ++i) {
+            ofs << "MANO INICIAL | " << i + 1 << " | ";
+            for (int id = 0; id < R::NUM_FICHAS; ++id)
+                if (R::tiene(histManos[i], id)) R::ficha(id).print(ofs);
+            ofs << " | " << histNames[i] << "\n";
+        }
+        ofs << "\n";
+        LineaMesa<R::NUM_FICHAS> mesa;
+        for (const Movimiento& m : historial) {
+            if (m.tipo == MOV_BLOQUEO) {
+                ofs << "SYSTEM | BLOQUEO | Ronda finalizada por bloqueo\n";
+                continue;
+            }
+            ofs << m.jugador + 1 << " | ";
+            if (m.tipo == MOV_PASA) ofs << "PASA";
+            else if (m.tipo == MOV_ROBA) { ofs << "ROBA "; R::ficha(m.ficha).print(ofs); }
+            else aplicarJugada<R>(mesa, m.ficha, m.lado).print(ofs);
+            ofs << " | ";
+            for (const auto& f : mesa) f.print(ofs);
+            ofs << " | " << histNames[m.jugador] << "\n";
+        }
+        ofs.close();
+    }
+
+    // Formato binario: "DOM2", reglas (doble, mano, máximo de jugadores, parejas, robo), nJugadores,
+    // (largo + nombre, cantidad + ids de la mano inicial) por jugador, nMovimientos, movimientos
+    void saveHistoryBinary(const string& filename) const {
+        ofstream ofs(filename, ios::binary);
+        if (!ofs.is_open()) {
+            cerr << "Error: no se pudo escribir el historial binario.\n";
+            return;
+        }
+        uint32_t reglas[5] = { (uint32_t)R::MAX_PIP, (uint32_t)R::MANO, (uint32_t)R::MAX_JUGADORES,
+                               (uint32_t)R::EQUIPOS, (uint32_t)R::ROBO };
+        uint32_t n = (uint32_t)histNames.size();
+        ofs.write("DOM2", 4);
+        ofs.write((const char*)reglas, sizeof reglas);
+        ofs.write((const char*)&n, sizeof n);
+        for (size_t i = 0; i < histNames.size(); ++i) {
+            uint32_t len = (uint32_t)histNames[i].size();
+            ofs.write((const char*)&len, sizeof len);
+            ofs.write(histNames[i].data(), len);
+            uint8_t ids[R::NUM_FICHAS];
+            uint32_t cuantas = 0;
+            for (int id = 0; id < R::NUM_FICHAS; ++id)
+                if (R::tiene(histManos[i], id)) ids[cuantas++] = (uint8_t)id;
+            ofs.write((const char*)&cuantas, sizeof cuantas);
+            ofs.write((const char*)ids, cuantas);
+        }
+        uint32_t m = (uint32_t)historial.size();
+        ofs.write((const char*)&m, sizeof m);
+        if (m) ofs.write((const char*)historial.data(), m * sizeof(Movimiento));
+    }
+
+    void clearHistory() {
+        historial.clear();
+    }
+
+    // Prepara una ronda nueva sin reservar memoria: reparte, registra las manos y elige quién inicia
+    void prepareRound() {
+#ifdef DOMINO_ESTADISTICAS
+        inicioRonda = chrono::steady_clock::now();
+#endif
+        DOMINO_CRONO(FASE_REPARTO);
+        clearHistory();
+        // asignar elemento a elemento reutiliza la capacidad de los strings ya existentes
+        histNames.resize(players.size());
+        for (size_t i = 0; i < players.size(); ++i) histNames[i] = players[i]->getName();
+
+        ++roundNumber;
+        dealRng.seed(semillaFlujo(baseSeed, roundNumber, 0));
+        drawRng.seed(semillaFlujo(baseSeed, roundNumber, 1));
+        createDeck();
+        dealHands();
+        for (int i = 0; i < (int)players.size(); ++i) {
+            histManos[i] = Mascara();
+            for (int k = 0; k < players[i]->handSize(); ++k)
+                histManos[i] |= R::bit(R::id(players[i]->tileAt(k)));
+        }
+        table.clear();
+        passesInRow = 0;
+        currentIdx = determineStarter();
+    }
+
+    // Coloca la ficha idx del jugador actual; lado se ignora con la mesa vacía. false si no encaja
+    bool placeTile(int idx, int lado) {
+        Jugador<R>* cur = players[currentIdx];
+        if (!table.empty()) {
+            int need = (lado == LADO_IZQ) ? table.front().first() : table.back().second();
+            if (!cur->tileAt(idx).canConnect(need)) return false;
+        } else {
+            lado = LADO_DER;
+        }
+        // sacamos la ficha real de la mano y la orientamos al colocarla
+        Ficha played = cur->playAt(idx);
+        aplicarJugada<R>(table, R::id(played), lado);
+        addHistory(currentIdx, MOV_JUGADA, R::id(played), lado);
+        DOMINO_CONTAR(jugadas, 1);
+        passesInRow = 0;
+        return true;
+    }
+
+    void passTurn() {
+        passesInRow++;
+        // registramos PASS en historial (no se cambia el tablero)
+        addHistory(currentIdx, MOV_PASA);
+        DOMINO_CONTAR(pases, 1);
+    }
+
+    // check bloqueo: if passesInRow >= players.size() => blocked OR isBlocked()
+    // (con robo, nadie puede jugar solo bloquea cuando el pozo está vacío)
+    bool roundBlocked() const {
+        DOMINO_CRONO(FASE_BLOQUEO);
+        return passesInRow >= (int)players.size() || (isBlocked() && (!R::ROBO || boneyard.empty()));
+    }
+
+    // pips que cuentan para el bloqueo: los del jugador, o los de su pareja completa
+    int sidePips(int i) const {
+        if (R::EQUIPOS) return players[i % 2]->handPips() + players[i % 2 + 2]->handPips();
+        return players[i]->handPips();
+    }
+
+    // ganador por bloqueo: menor cantidad de pips en mano (por parejas devuelve 0 o 1)
+    int blockedWinner() const {
+        DOMINO_CRONO(FASE_BLOQUEO);
+        int winner = 0;
+        int minPips = sidePips(0);
+        int lados = R::EQUIPOS ? 2 : (int)players.size();
+        for (int i = 1; i < lados; ++i) {
+            int pips = sidePips(i);
+            if (pips < minPips) { minPips = pips; winner = i; }
+        }
+        return winner;
+    }
+
+    // suma la victoria al jugador y, en el juego por parejas, a su compañero
+    void awardWin(int i) {
+        players[i]->addWin();
+        if (R::EQUIPOS) players[(i + 2) % 4]->addWin();
+    }
+
+    // cierra las estadísticas de la ronda: margen = pips que quedan en manos de los lados perdedores
+    void recordRoundEnd(int ganador, bool porBloqueo) {
+#ifdef DOMINO_ESTADISTICAS
+        int lados = R::EQUIPOS ? 2 : (int)players.size();
+        int lado = R::EQUIPOS ? ganador % 2 : ganador;
+        int margen = 0;
+        for (int i = 0; i < lados; ++i) if (i != lado) margen += sidePips(i);
+        uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicioRonda).count();
+        stats.finRonda(ns, margen, porBloqueo);
+#else
+        (void)ganador; (void)porBloqueo;
+#endif
+    }
+
+    // decisión del jugador actual antes de colocar la ficha idx: mano, extremos y jugadas legales
+    // (con la mesa vacía toda la mano es legal y se registra del lado derecho, como en el historial)
+    void recordDecision(DatasetDomino<R>& dataset, int idx, int lado) const {
+        const Jugador<R>* cur = players[currentIdx];
+        Mascara mano = Mascara();
+        for (int k = 0; k < cur->handSize(); ++k) mano |= R::bit(R::id(cur->tileAt(k)));
+        if (table.empty()) {
+            dataset.decision(currentIdx, -1, -1, mano, Mascara(), mano, R::id(cur->tileAt(idx)), lado);
+            return;
+        }
+        int L = table.front().first(), R_ = table.back().second();
+        dataset.decision(currentIdx, L, R_, mano, mano & R::conValor(L), mano & R::conValor(R_),
+                         R::id(cur->tileAt(idx)), lado);
+    }
+
+    void recordDatasetEnd(DatasetDomino<R>& dataset, int ganador) const {
+        int pips[R::MAX_JUGADORES];
+        int lados = R::EQUIPOS ? 2 : (int)players.size();
+        for (int i = 0; i < lados; ++i) pips[i] = sidePips(i);
+        dataset.finRonda(R::EQUIPOS ? ganador % 2 : ganador, pips, lados);
+    }
+
+public:
+    JuegoDomino() : currentIdx(0), passesInRow(0), baseSeed(static_cast<uint64_t>(time(nullptr))), roundNumber(0),
+                    histInteractivo(false) {
+        historial.reserve(R::NUM_FICHAS * R::MAX_JUGADORES + 1);
+        histNames.reserve(R::MAX_JUGADORES);
+    }
+
+    ~JuegoDomino() {
+        // guardar historial (por si acaso); las rondas simuladas no pisan el historial de la última partida
+        if (histInteractivo) saveHistoryToFile();
+        // liberar memoria jugadores
+        for (auto p : players) delete p;
+        players.clear();
+    }
+
+    // configurar N jugadores humanos
+    void setupPlayersInteractive() {
+        for (auto p : players) delete p;
+        players.clear();
+
+        int n;
+        while (true) {
+            cout << "¿Cuántos jugadores? (" << R::MIN_JUGADORES << "-" << R::MAX_JUGADORES << "): ";
+            if (!(cin >> n)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
+            if (n >= R::MIN_JUGADORES && n <= R::MAX_JUGADORES) break;
+            cout << "Ingrese entre " << R::MIN_JUGADORES << " y " << R::MAX_JUGADORES << ".\n";
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        if (R::EQUIPOS) cout << "Parejas: jugadores 1 y 3 contra 2 y 4.\n";
+        for (int i = 0; i < n; ++i) {
+            string nm;
+            cout << "Nombre jugador " << i+1 << ": ";
+            getline(cin, nm);
+            if (nm.empty()) nm = "Jugador" + to_string(i+1);
+            players.push_back(new Jugador<R>(nm));
+        }
+    }
+
+    // configurar N jugadores automáticos (simulación sin consola)
+    void setupPlayersAuto(int n) {
+        for (auto p : players) delete p;
+        players.clear();
+        for (int i = 0; i < n; ++i) players.push_back(new Jugador<R>("Jugador" + to_string(i+1)));
+    }
+
+    // jugadores automáticos con nombres dados (pueden repetirse)
+    void setupPlayersAuto(const vector<string>& nombres) {
+        for (auto p : players) delete p;
+        players.clear();
+        for (const auto& nm : nombres) players.push_back(new Jugador<R>(nm));
+    }
+
+    // fija la semilla base y reinicia la numeración de rondas: mismas semillas, mismas partidas
+    void seed(uint64_t s) { baseSeed = s; roundNumber = 0; }
+
+
+    void startRound() {
+        prepareRound();
+        histInteractivo = true;
+        cout << "\nInicia la ronda. Comienza: " << players[currentIdx]->getName() << "\n";
+        playRound();
+    }
+
+
+    void playRound() {
+        bool roundActive = true;
+
+        while (roundActive) {
+            showTable();
+
+            Jugador<R>* cur = players[currentIdx];
+            DOMINO_CONTAR(turnos, 1);
+            cout << "\nTurno: " << cur->getName() << "\n";
+            cur->showHand();
+
+            // con robo: si no puede jugar, roba del pozo hasta poder
+            if (R::ROBO && !canPlay(cur) && !boneyard.empty()) {
+                int antes = cur->handSize();
+                int robadas = drawUntilPlayable();
+                cout << cur->getName() << " roba " << robadas << " ficha(s) del pozo:";
+                for (int k = antes; k < cur->handSize(); ++k) { cout << " "; cur->tileAt(k).print(); }
+                cout << "\n";
+                cur->showHand();
+            }
+
+            // si no puede jugar y no hay mesa vacía -> pasar
+            if (!canPlay(cur)) {
+                cout << cur->getName() << " no tiene jugadas válidas y pasa.\n";
+                passTurn();
+            } else {
+                // pedir acción al jugador
+                int choice = -1;
+                while (true) {
+                    cout << "Ingrese índice de ficha a jugar (1-" << cur->handSize() << ") o 0 para pasar: ";
+                    if (!(cin >> choice)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout << "Entrada inválida.\n"; continue; }
+                    if (choice == 0) { cout << cur->getName() << " pasa.\n"; passTurn(); break; }
+                    int idx = choice - 1;
+                    if (idx < 0 || idx >= cur->handSize()) { cout << "Índice fuera de rango.\n"; continue; }
+                    // si mesa vacía aceptar directamente
+                    if (table.empty()) {
+                        placeTile(idx, LADO_DER);
+                        cout << cur->getName() << " coloca "; table.back().print(); cout << " (mesa vacía)\n";
+                        break;
+                    }
+                    // else preguntar lado
+                    char side;
+                    cout << "Colocar en (I)zquierda o (D)erecha? ";
+                    cin >> side; side = toupper(side);
+                    if (side != 'I' && side != 'D') { cout << "Lado inválido.\n"; continue; }
+
+                    if (!placeTile(idx, side == 'I' ? LADO_IZQ : LADO_DER)) { cout << "Esa ficha no encaja en ese lado.\n"; continue; }
+                    if (side == 'I') {
+                        cout << cur->getName() << " coloca en izquierda "; table.front().print(); cout << "\n";
+                    } else {
+                        cout << cur->getName() << " coloca en derecha "; table.back().print(); cout << "\n";
+                    }
+                    break;
+                } // end action loop
+            }
+
+            // check win
+            if (cur->handSize() == 0) {
+                cout << "\n***** " << cur->getName() << " se quedó sin fichas y gana la ronda! *****\n";
+                if (R::EQUIPOS) cout << "Gana también su pareja: " << players[(currentIdx + 2) % 4]->getName() << "\n";
+                awardWin(currentIdx);
+                recordRoundEnd(currentIdx, false);
+                roundActive = false;
+            } else if (roundBlocked()) {
+                cout << "\n***** Ronda BLOQUEADA *****\n";
+                for (int i = 1; i < (int)players.size(); ++i)
+                    cout << players[i]->getName() << " tiene " << players[i]->handPips() << " pips.\n";
+                int winner = blockedWinner();
+                if (R::EQUIPOS)
+                    cout << "La pareja " << players[winner]->getName() << " y " << players[winner + 2]->getName()
+                         << " tiene menor pips (" << sidePips(winner) << ") y gana la ronda.\n";
+                else
+                    cout << players[winner]->getName() << " tiene menor pips (" << sidePips(winner) << ") y gana la ronda.\n";
+                awardWin(winner);
+                // registrar en historial que la ronda terminó por bloqueo (registro final)
+                addHistory(0, MOV_BLOQUEO);
+                recordRoundEnd(winner, true);
+                roundActive = false;
+            }
+
+            // Avanzar al siguiente jugador siempre si la ronda sigue
+            if (roundActive) {
+                currentIdx = (currentIdx + 1) % players.size();
+            }
+        } // end while roundActive
+
+        // mostrar victorias acumuladas
+        cout << "\nVictorias acumuladas:\n";
+        for (auto p : players) cout << p->getName() << ": " << p->getWins() << "\n";
+
+        // Al finalizar la ronda, guardamos historial
+        saveHistoryToFile();
+        cout << "\nHistorial guardado en 'historial_domino.txt'\n";
+    }
+
+    // Ronda completa sin consola ni archivos: cada jugador coloca la primera ficha que encaje
+    // (izquierda antes que derecha). Devuelve el índice del ganador.
+    // Con dataset, registra cada decisión y el resultado de la ronda.
+    int simulateRound(DatasetDomino<R>* dataset = nullptr) {
+        beginSimulatedRound();
+        int ganador;
+        while ((ganador = simulateTurn(dataset)) < 0) {}
+        return ganador;
+    }
+
+    // Ronda simulada paso a paso: beginSimulatedRound reparte y simulateTurn juega un turno
+    // (robos incluidos); devuelve el ganador al terminar la ronda y -1 mientras siga
+    void beginSimulatedRound() {
+        prepareRound();
+        histInteractivo = false;
+    }
+
+    int simulateTurn(DatasetDomino<R>* dataset = nullptr) {
+        Jugador<R>* cur = players[currentIdx];
+        DOMINO_CONTAR(turnos, 1);
+        int L = table.empty() ? -1 : table.front().first();
+        int R_ = table.empty() ? -1 : table.back().second();
+        if (R::ROBO && !table.empty()) drawUntilPlayable();
+        int k = 0, lado = LADO_IZQ;
+        {
+            DOMINO_CRONO(FASE_JUGADAS);
+            for (; k < cur->handSize(); ++k) {
+                const Ficha f = cur->tileAt(k);
+                if (table.empty() || f.canConnect(L)) { lado = LADO_IZQ; break; }
+                if (f.canConnect(R_)) { lado = LADO_DER; break; }
+            }
+        }
+        if (k < cur->handSize()) {
+            if (dataset) recordDecision(*dataset, k, table.empty() ? LADO_DER : lado);
+            placeTile(k, lado);
+        } else {
+            passTurn();
+        }
+
+        if (cur->handSize() == 0) {
+            awardWin(currentIdx);
+            recordRoundEnd(currentIdx, false);
+            if (dataset) recordDatasetEnd(*dataset, currentIdx);
+            return currentIdx;
+        }
+        if (roundBlocked()) {
+            int winner = blockedWinner();
+            awardWin(winner);
+            addHistory(0, MOV_BLOQUEO);
+            recordRoundEnd(winner, true);
+            if (dataset) recordDatasetEnd(*dataset, winner);
+            return winner;
+        }
+        currentIdx = (currentIdx + 1) % players.size();
+        return -1;
+    }
+
+    // Guarda el historial de la última ronda en "<base>.txt" y "<base>.bin"
+    void saveHistoryAs(const string& base) const { saveHistoryToFile(base); }
+
+    // Estado vivo de la ronda en el formato de ReplayDomino (para compararlo con la reproducción);
+    // la ronda se da por terminada solo cuando el último registro la cierra
+    void estadoActual(EstadoDomino<R>& e) const {
+        Mascara resto = Mascara();
+        for (int id = 0; id < R::NUM_FICHAS; ++id) resto |= R::bit(id);
+        for (int i = 0; i < R::MAX_JUGADORES; ++i) {
+            e.manos[i] = Mascara();
+            if (i < (int)players.size())
+                for (int k = 0; k < players[i]->handSize(); ++k) e.manos[i] |= R::bit(R::id(players[i]->tileAt(k)));
+            resto &= ~e.manos[i];
+        }
+        for (const auto& f : table) resto &= ~R::bit(R::id(f));
+        e.pozo = resto;
+        e.mesa = table;
+        e.turno = currentIdx;
+        e.pasesSeguidos = passesInRow;
+        e.bloqueada = false;
+        e.terminada = !historial.empty() && historial.back().tipo == MOV_BLOQUEO;
+        for (auto p : players) if (p->handSize() == 0) e.terminada = true;
+    }
+
+    size_t historySize() const { return historial.size(); }
+    const Movimiento& historyAt(size_t k) const { return historial[k]; }
+    int playerCount() const { return (int)players.size(); }
+
+#ifdef DOMINO_ESTADISTICAS
+    const EstadisticasDomino& estadisticas() const { return stats; }
+#endif
+
+    // Reconstruye la mesa tras los primeros n movimientos del historial
+    void reconstruirMesa(size_t n, LineaMesa<R::NUM_FICHAS>& mesa) const {
+        mesa.clear();
+        for (size_t k = 0; k < n && k < historial.size(); ++k)
+            if (historial[k].tipo == MOV_JUGADA) aplicarJugada<R>(mesa, historial[k].ficha, historial[k].lado);
+    }
+
+    // Carga un historial (texto o binario), valida todos los movimientos y permite saltar a cualquier punto
+    void auditHistory() {
+        string archivo;
+        cout << "Archivo de historial (Enter = historial_domino.bin): ";
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        getline(cin, archivo);
+        if (archivo.empty()) archivo = "historial_domino.bin";
+
+        ReplayDomino<R> replay;
+        if (!replay.cargar(archivo) || !replay.validar()) {
+            cout << "Historial inválido: " << replay.mensajeError() << "\n";
+            return;
+        }
+        cout << "Historial válido: " << replay.numMovimientos() << " movimientos, "
+             << replay.numJugadores() << " jugadores.\n";
+
+        while (true) {
+            long idx;
+            cout << "Ir al movimiento (0-" << replay.numMovimientos() << ", -1 para volver): ";
+            if (!(cin >> idx)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
+            if (idx < 0) break;
+            EstadoDomino<R> e;
+            if (!replay.irA((size_t)idx, e)) { cout << "Índice fuera de rango.\n"; continue; }
+            cout << "\n--- MESA tras " << idx << " movimientos ---\n";
+            if (e.mesa.empty()) cout << "(vacía)";
+            for (const auto& f : e.mesa) { f.print(); cout << " "; }
+            cout << "\n";
+            for (int i = 0; i < replay.numJugadores(); ++i) {
+                cout << replay.nombre(i) << ": ";
+                for (int id = 0; id < R::NUM_FICHAS; ++id)
+                    if (R::tiene(e.manos[i], id)) R::ficha(id).print();
+                cout << "\n";
+            }
+            if (e.terminada) cout << "Ronda terminada.\n";
+            else {
+                cout << "Turno: " << replay.nombre(e.turno) << "\n";
+                showEndgameAnalysis(e, replay);
+            }
+        }
+    }
+
+    // Resultado óptimo desde un estado del historial (si quedan pocas fichas y no hay pozo por robar)
+    void showEndgameAnalysis(const EstadoDomino<R>& e, const ReplayDomino<R>& replay) const {
+        const int LIMITE = 16;
+        int n = replay.numJugadores(), restantes = 0;
+        for (int i = 0; i < n; ++i)
+            for (int id = 0; id < R::NUM_FICHAS; ++id) if (R::tiene(e.manos[i], id)) ++restantes;
+        if (e.mesa.empty()) return;
+        if (R::ROBO && e.pozo != Mascara()) { cout << "(análisis exacto disponible cuando el pozo esté vacío)\n"; return; }
+        if (restantes > LIMITE) { cout << "(análisis exacto disponible con " << LIMITE << " fichas o menos en juego)\n"; return; }
+
+        SolverFinal<R> solver;
+        auto t0 = chrono::steady_clock::now();
+        typename SolverFinal<R>::Resultado r =
+            solver.resolver(e.manos, n, e.mesa.front().first(), e.mesa.back().second(), e.turno);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        cout << "Final óptimo: gana ";
+        if (R::EQUIPOS) cout << "la pareja " << replay.nombre(r.ganador) << " y " << replay.nombre(r.ganador + 2);
+        else cout << replay.nombre(r.ganador);
+        cout << " por " << r.margen << " pips.";
+        if (r.ficha >= 0) {
+            cout << " Mejor jugada: "; R::ficha(r.ficha).print();
+            cout << (r.lado == LADO_IZQ ? " a la izquierda." : " a la derecha.");
+        } else {
+            cout << " " << replay.nombre(e.turno) << " debe pasar.";
+        }
+        cout << "\n(estados: " << solver.estados() << ", consultas: " << solver.numConsultas()
+             << ", aciertos de caché: " << (int)(solver.tasaAciertos() * 100) << "%, tiempo: " << ms << " ms)\n";
+    }
+
+    // menu principal / control de sesiones y reinicio
+    void mainMenu() {
+        bool running = true;
+        while (running) {
+            cout << "\n=== MENU PRINCIPAL ===\n";
+            cout << "1) Configurar jugadores\n";
+            cout << "2) Nueva ronda\n";
+            cout << "3) Ver marcador\n";
+            cout << "4) Reiniciar marcador y jugadores\n";
+            cout << "5) Auditar historial guardado\n";
+            cout << "6) Salir\n";
+            cout << "Seleccione opcion: ";
+            int opt;
+            if (!(cin >> opt)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); continue; }
+            switch (opt) {
+                case 1:
+                    setupPlayersInteractive();
+                    break;
+                case 2:
+                    if (players.empty()) { cout << "Configure jugadores primero (opcion 1).\n"; break; }
+                    startRound();
+                    break;
+                case 3:
+                    for (auto p : players) cout << p->getName() << ": " << p->getWins() << " victorias\n";
+                    break;
+                case 4:
+                    for (auto p : players) { p->clearHand(); delete p; }
+                    players.clear();
+                    cout << "Marcador y jugadores reiniciados. Configure nuevamente.\n";
+                    break;
+                case 5:
+                    auditHistory();
+                    break;
+                case 6:
+                    running = false;
+                    break;
+                default:
+                    cout << "Opcion no valida.\n";
+            }
+        }
+    }
+};
+
+#endif // JUEGO_DOMINO_H
@@ -0,0 +1,1081 @@
+// Listado estudiantil: lista enlazada con diario de escritura anticipada, índices de texto y agregados de promedio.
+// Lo usan codigo1.cpp y benchmark.cpp.
+#ifndef LISTADO_ESTUDIANTIL_H
+#define LISTADO_ESTUDIANTIL_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// Estructura para guardar los datos del estudiante
+struct Estudiante {
+    string nombreCompleto;
+    int anoNacimiento;
+    int identificacion;
+    float promedio;
+    string email;
+};
+
+// Nodo de la lista enlazada simple
+struct Nodo {
+    Estudiante dato;
+    Nodo* siguiente;
+
+    Nodo(const Estudiante& est) : dato(est), siguiente(nullptr) {}
+};
+
+class ListadoEstudiantil;
+
+// Tipos de registro del diario
+enum TipoRegistro : uint8_t { REG_INSERTAR = 1, REG_ELIMINAR = 2, REG_INVERTIR = 3 };
+
+// Diario de escritura anticipada (write-ahead log) del listado.
+// Archivos: "estudiantes.<g>.snap" (copia completa, generación g) y "estudiantes.<g>.wal"
+// (mutaciones posteriores a la copia g). Recuperar = cargar la copia más reciente y reproducir
+// los diarios de esa generación en adelante. Cada mutación agrega un registro corto al diario
+// (O(1) de E/S); un hilo escritor junta los registros pendientes y hace un solo fsync por lote.
+// Cuando el diario supera el tamaño de la última copia completa (mínimo UMBRAL_COMPACTAR bytes)
+// se rota a la generación siguiente; otro hilo arma la copia nueva con la copia anterior y los
+// diarios ya cerrados, y borra los archivos viejos. Así cada byte de copia se paga con al menos
+// un byte de diario, y las mutaciones nunca copian la lista.
+class DiarioEstudiantil {
+public:
+    static const size_t UMBRAL_COMPACTAR = 256 * 1024;
+
+private:
+    string base;                 // prefijo de los archivos
+    FILE* archivo;               // diario de la generación actual
+    uint64_t generacion;
+    size_t bytesDiario;          // tamaño del diario actual (para decidir la compactación)
+    uint64_t generacionCopia;    // generación de la última copia completa (0 si no hay)
+    size_t bytesCopia;           // y su tamaño: el umbral crece con la lista
+
+    // estado compartido con el hilo escritor
+    mutex mtx;
+    condition_variable hayTrabajo, hayDurable;
+    vector<char> pendiente;      // registros codificados aún no escritos
+    size_t corte;                // con rotación pedida: bytes de 'pendiente' que van al diario viejo
+    bool rotar;
+    uint64_t lsnPendiente, lsnDurable;
+    bool detener;
+    size_t lotes, fsyncs;
+    thread escritor;
+    thread compactador;
+    bool compactando;
+
+    static uint32_t fnv1a(const char* p, size_t n, uint32_t h = 2166136261u) {
+        for (size_t i = 0; i < n; ++i) { h ^= (uint8_t)p[i]; h *= 16777619u; }
+        return h;
+    }
+
+    static void ponerU32(vector<char>& b, uint32_t v) { b.insert(b.end(), (char*)&v, (char*)&v + 4); }
+    static void ponerTexto(vector<char>& b, const string& t) {
+        ponerU32(b, (uint32_t)t.size());
+        b.insert(b.end(), t.begin(), t.end());
+    }
+    static bool leerU32(const char*& p, const char* fin, uint32_t& v) {
+        if (fin - p < 4) return false;
+        memcpy(&v, p, 4); p += 4;
+        return true;
+    }
+    static bool leerTexto(const char*& p, const char* fin, string& t) {
+        uint32_t n;
+        if (!leerU32(p, fin, n) || (size_t)(fin - p) < n) return false;
+        t.assign(p, n); p += n;
+        return true;
+    }
+
+public:
+    static void codificar(vector<char>& b, const Estudiante& e) {
+        ponerTexto(b, e.nombreCompleto);
+        ponerU32(b, (uint32_t)e.anoNacimiento);
+        ponerU32(b, (uint32_t)e.identificacion);
+        uint32_t prom;
+        memcpy(&prom, &e.promedio, 4);
+        ponerU32(b, prom);
+        ponerTexto(b, e.email);
+    }
+    static bool decodificar(const char*& p, const char* fin, Estudiante& e) {
+        uint32_t ano, id, prom;
+        if (!leerTexto(p, fin, e.nombreCompleto) || !leerU32(p, fin, ano) || !leerU32(p, fin, id) ||
+            !leerU32(p, fin, prom) || !leerTexto(p, fin, e.email)) return false;
+        e.anoNacimiento = (int)ano;
+        e.identificacion = (int)id;
+        memcpy(&e.promedio, &prom, 4);
+        return true;
+    }
+
+private:
+    string nombreSnap(uint64_t g) const { return base + "." + to_string(g) + ".snap"; }
+    string nombreDiario(uint64_t g) const { return base + "." + to_string(g) + ".wal"; }
+
+    // fflush + fsync: el contenido queda en disco antes de confirmar
+    static void sincronizarArchivo(FILE* f) {
+        fflush(f);
+#ifdef _WIN32
+        _commit(_fileno(f));
+#else
+        fsync(fileno(f));
+#endif
+    }
+
+    // en POSIX, un rename solo es durable tras sincronizar el directorio
+    void sincronizarDirectorio() const {
+#ifndef _WIN32
+        string dir = filesystem::path(base).parent_path().string();
+        int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (fd >= 0) { fsync(fd); close(fd); }
+#endif
+    }
+
+    FILE* crearDiario(uint64_t g) {
+        FILE* f = fopen(nombreDiario(g).c_str(), "wb");
+        if (!f) return nullptr;
+        fwrite("EWAL", 1, 4, f);
+        fwrite(&g, sizeof g, 1, f);
+        sincronizarArchivo(f);
+        sincronizarDirectorio();
+        return f;
+    }
+
+    // Copia completa: "ESNP", generación, cantidad, estudiantes, fnv de todo lo anterior.
+    // Se escribe en un temporal y se renombra, así nunca queda una copia a medias con nombre válido
+    bool escribirSnapshot(uint64_t g, const vector<Estudiante>& ests, size_t& bytes) {
+        vector<char> b;
+        b.insert(b.end(), "ESNP", "ESNP" + 4);
+        b.insert(b.end(), (char*)&g, (char*)&g + 8);
+        ponerU32(b, (uint32_t)ests.size());
+        for (const auto& e : ests) codificar(b, e);
+        ponerU32(b, fnv1a(b.data(), b.size()));
+        string tmp = nombreSnap(g) + ".tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+        bool ok = fwrite(b.data(), 1, b.size(), f) == b.size();
+        sincronizarArchivo(f);
+        fclose(f);
+        if (!ok || rename(tmp.c_str(), nombreSnap(g).c_str()) != 0) { remove(tmp.c_str()); return false; }
+        sincronizarDirectorio();
+        bytes = b.size();
+        return true;
+    }
+
+    static bool leerArchivo(const string& nombre, vector<char>& b) {
+        ifstream in(nombre, ios::binary);
+        if (!in) return false;
+        b.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Lee la copia completa de la generación g; false si falta o está dañada
+    bool leerSnapshot(uint64_t g, vector<Estudiante>& ests, size_t& bytes) const {
+        vector<char> b;
+        if (!leerArchivo(nombreSnap(g), b) || b.size() < 20 || memcmp(b.data(), "ESNP", 4) != 0) return false;
+        uint32_t suma, n;
+        memcpy(&suma, b.data() + b.size() - 4, 4);
+        if (fnv1a(b.data(), b.size() - 4) != suma) return false;
+        const char* p = b.data() + 16;
+        const char* fin = b.data() + b.size() - 4;
+        memcpy(&n, b.data() + 12, 4);
+        ests.assign(n, Estudiante());
+        for (uint32_t i = 0; i < n; ++i)
+            if (!decodificar(p, fin, ests[i])) return false;
+        bytes = b.size();
+        return true;
+    }
+
+    // Reproduce sobre 'destino' los registros íntegros del diario g (ya leído en b);
+    // un registro incompleto o dañado marca el final. false si el encabezado no es de g
+    template <class Destino>
+    static bool reproducirDiario(const vector<char>& b, uint64_t g, Destino& destino,
+                                 size_t& validos, size_t& recuperados) {
+        uint64_t gArchivo = 0;
+        if (b.size() >= 12) memcpy(&gArchivo, b.data() + 4, 8);
+        if (b.size() < 12 || memcmp(b.data(), "EWAL", 4) != 0 || gArchivo != g) return false;
+        const char* p = b.data() + 12;
+        const char* fin = b.data() + b.size();
+        while (fin - p >= 9) {
+            const char* ini = p;
+            uint8_t tipo = (uint8_t)*p++;
+            uint32_t len = 0, suma = 0;
+            leerU32(p, fin, len);
+            if ((size_t)(fin - p) < (size_t)len + 4) { p = ini; break; }
+            const char* datos = p;
+            p += len;
+            leerU32(p, fin, suma);
+            if (fnv1a(ini, 5 + len) != suma) { p = ini; break; }
+            if (tipo == REG_INSERTAR) {
+                Estudiante e;
+                const char* q = datos;
+                if (!decodificar(q, datos + len, e)) { p = ini; break; }
+                destino.insertar(e);
+            } else if (tipo == REG_ELIMINAR && len == sizeof(int)) {
+                int id;
+                memcpy(&id, datos, sizeof id);
+                destino.eliminar(id);
+            } else if (tipo == REG_INVERTIR) {
+                destino.invertir();
+            } else {
+                p = ini; break;
+            }
+            ++recuperados;
+        }
+        validos = p - b.data();
+        return true;
+    }
+
+    // Lista mínima para reproducir el diario en el hilo compactador, sin índices ni agregados.
+    // Misma semántica que ListadoEstudiantil: insertar al final, eliminar el primero con ese id, invertir
+    class ListaReproduccion {
+    private:
+        list<Estudiante> datos;
+        unordered_map<int, vector<list<Estudiante>::iterator>> porId;
+        bool invertida = false;   // con la lista invertida el final lógico es datos.begin()
+
+    public:
+        void insertar(const Estudiante& e) {
+            porId[e.identificacion].push_back(datos.insert(invertida ? datos.begin() : datos.end(), e));
+        }
+        void eliminar(int id) {
+            auto m = porId.find(id);
+            if (m == porId.end()) return;
+            vector<list<Estudiante>::iterator>& its = m->second;
+            size_t k = 0;
+            if (its.size() > 1) {
+                // id repetido: el primero desde la cabeza lógica
+                list<Estudiante>::iterator primero = datos.end();
+                if (!invertida) {
+                    for (auto it = datos.begin(); it != datos.end(); ++it)
+                        if (it->identificacion == id) { primero = it; break; }
+                } else {
+                    for (auto it = datos.end(); it != datos.begin();)
+                        if ((--it)->identificacion == id) { primero = it; break; }
+                }
+                k = find(its.begin(), its.end(), primero) - its.begin();
+            }
+            datos.erase(its[k]);
+            its.erase(its.begin() + k);
+            if (its.empty()) porId.erase(m);
+        }
+        void invertir() { invertida = !invertida; }
+
+        vector<Estudiante> volcar() {
+            vector<Estudiante> v;
+            v.reserve(datos.size());
+            if (!invertida) for (auto& e : datos) v.push_back(move(e));
+            else for (auto it = datos.rbegin(); it != datos.rend(); ++it) v.push_back(move(*it));
+            return v;
+        }
+    };
+
+    // Hilo compactador: copia 'desde' + diarios desde..hasta (todos cerrados) = copia de hasta+1
+    void compactarDiarios(uint64_t desde, uint64_t hasta) {
+        ListaReproduccion lista;
+        vector<Estudiante> ests;
+        vector<char> b;
+        size_t bytes = 0, validos, recuperados = 0;
+        bool ok = true;
+        if (leerSnapshot(desde, ests, bytes)) {
+            for (const auto& e : ests) lista.insertar(e);
+        } else {
+            ok = desde == 0;  // sin copia solo se puede partir del primer diario
+        }
+        ests.clear();
+        for (uint64_t g = desde; ok && g <= hasta; ++g)
+            ok = leerArchivo(nombreDiario(g), b) && reproducirDiario(b, g, lista, validos, recuperados) &&
+                 validos == b.size();
+        ok = ok && escribirSnapshot(hasta + 1, lista.volcar(), bytes);
+        if (ok) borrarViejos(hasta + 1);
+        lock_guard<mutex> lk(mtx);
+        if (ok) { generacionCopia = hasta + 1; bytesCopia = bytes; }
+        compactando = false;
+    }
+
+    // Reconoce "<prefijo><dígitos><sufijo>" con sufijo .snap, .wal o .snap.tmp; cualquier otro
+    // archivo con el mismo prefijo (p. ej. estudiantes.txt) no es del diario
+    static bool nombreGeneracion(const string& n, const string& prefijo, uint64_t& g, string& sufijo) {
+        if (n.compare(0, prefijo.size(), prefijo) != 0) return false;
+        const char* ini = n.c_str() + prefijo.size();
+        if (*ini < '0' || *ini > '9') return false;
+        char* fin;
+        g = strtoull(ini, &fin, 10);
+        sufijo = fin;
+        return sufijo == ".snap" || sufijo == ".wal" || sufijo == ".snap.tmp";
+    }
+
+    // borra copias y diarios de generaciones anteriores a g
+    void borrarViejos(uint64_t g) {
+        error_code ec;
+        filesystem::path dir = filesystem::path(base).parent_path();
+        string prefijo = filesystem::path(base).filename().string() + ".";
+        uint64_t gen;
+        string sufijo;
+        for (const auto& ent : filesystem::directory_iterator(dir.empty() ? "." : dir, ec)) {
+            if (!nombreGeneracion(ent.path().filename().string(), prefijo, gen, sufijo)) continue;
+            if (gen < g || (sufijo == ".snap.tmp" && gen <= g)) filesystem::remove(ent.path(), ec);
+        }
+    }
+
+    static void escribirLote(FILE* f, const char* datos, size_t n) {
+        if (n) fwrite(datos, 1, n, f);
+        sincronizarArchivo(f);
+    }
+
+    // Hilo escritor: commit en grupo. Toma todo lo pendiente, lo escribe y hace un solo fsync
+    void bucleEscritor() {
+        vector<char> lote;
+        unique_lock<mutex> lk(mtx);
+        while (true) {
+            hayTrabajo.wait(lk, [this] { return detener || !pendiente.empty() || rotar; });
+            if (pendiente.empty() && !rotar && detener) break;
+            lote.swap(pendiente);
+            pendiente.clear();
+            uint64_t lsn = lsnPendiente;
+            bool hayRotacion = rotar;
+            size_t c = corte;
+            uint64_t desde = generacionCopia;
+            rotar = false;
+            lk.unlock();
+
+            size_t hechos = 1;
+            uint64_t gen = generacion;
+            if (!hayRotacion) {
+                escribirLote(archivo, lote.data(), lote.size());
+            } else {
+                // lo anterior al corte cierra el diario viejo; lo demás abre la generación nueva
+                escribirLote(archivo, lote.data(), c);
+                fclose(archivo);
+                uint64_t vieja = gen;
+                FILE* nuevo = crearDiario(vieja + 1);
+                if (nuevo) {
+                    archivo = nuevo;
+                    gen = vieja + 1;
+                    if (compactador.joinable()) compactador.join();
+                    compactador = thread(&DiarioEstudiantil::compactarDiarios, this, desde, vieja);
+                } else {
+                    // sin diario nuevo se sigue en el actual y no se compacta
+                    cerr << "Error: no se pudo crear el diario " << nombreDiario(vieja + 1) << ".\n";
+                    archivo = fopen(nombreDiario(vieja).c_str(), "ab");
+                    lock_guard<mutex> g(mtx);
+                    compactando = false;
+                }
+                escribirLote(archivo, lote.data() + c, lote.size() - c);
+                hechos = 3;
+            }
+
+            lk.lock();
+            generacion = gen;
+            ++lotes;
+            fsyncs += hechos;
+            lsnDurable = lsn;
+            hayDurable.notify_all();
+        }
+    }
+
+public:
+    explicit DiarioEstudiantil(const string& prefijo = "estudiantes")
+        : base(prefijo), archivo(nullptr), generacion(0), bytesDiario(0), generacionCopia(0), bytesCopia(0),
+          corte(0), rotar(false),
+          lsnPendiente(0), lsnDurable(0), detener(false), lotes(0), fsyncs(0), compactando(false) {}
+
+    ~DiarioEstudiantil() { cerrar(); }
+
+    // Reconstruye la lista desde disco y deja el diario listo para agregar registros
+    bool abrir(ListadoEstudiantil& lista, size_t& recuperados);
+
+    // Agrega un registro al lote pendiente; devuelve su número de secuencia (LSN).
+    // Si el diario ya pesa más que la última copia, pide rotar justo después de este registro
+    uint64_t anotar(TipoRegistro tipo, const vector<char>& datos) {
+        lock_guard<mutex> lk(mtx);
+        size_t ini = pendiente.size();
+        pendiente.push_back((char)tipo);
+        ponerU32(pendiente, (uint32_t)datos.size());
+        pendiente.insert(pendiente.end(), datos.begin(), datos.end());
+        ponerU32(pendiente, fnv1a(pendiente.data() + ini, pendiente.size() - ini));
+        bytesDiario += pendiente.size() - ini;
+        if (!compactando && !rotar && bytesDiario > max(UMBRAL_COMPACTAR, bytesCopia)) {
+            compactando = true;
+            rotar = true;
+            corte = pendiente.size();
+            bytesDiario = 0;
+        }
+        hayTrabajo.notify_one();
+        return ++lsnPendiente;
+    }
+
+    // Espera a que el registro lsn (y todos los anteriores) estén en disco
+    void esperar(uint64_t lsn) {
+        unique_lock<mutex> lk(mtx);
+        hayDurable.wait(lk, [this, lsn] { return lsnDurable >= lsn; });
+    }
+    void esperarTodo() {
+        uint64_t lsn;
+        { lock_guard<mutex> lk(mtx); lsn = lsnPendiente; }
+        esperar(lsn);
+    }
+
+    void cerrar() {
+        if (!archivo) return;
+        {
+            lock_guard<mutex> lk(mtx);
+            detener = true;
+            hayTrabajo.notify_one();
+        }
+        if (escritor.joinable()) escritor.join();
+        if (compactador.joinable()) compactador.join();
+        fclose(archivo);
+        archivo = nullptr;
+    }
+
+    uint64_t numGeneracion() { lock_guard<mutex> lk(mtx); return generacion; }
+    size_t numLotes() { lock_guard<mutex> lk(mtx); return lotes; }
+    size_t numFsyncs() { lock_guard<mutex> lk(mtx); return fsyncs; }
+};
+
+// Texto en minúsculas (ASCII): las búsquedas no distinguen mayúsculas
+inline string minusculas(const string& t) {
+    string r = t;
+    for (char& c : r) if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+    return r;
+}
+
+// Nodo del trie compacto: cada arista guarda un fragmento completo en vez de un solo carácter
+struct NodoTrie {
+    string etiqueta;                // fragmento de la arista que llega a este nodo
+    map<char, NodoTrie*> hijos;     // por primer carácter de la etiqueta del hijo
+    vector<Nodo*> valores;          // estudiantes cuya clave termina exactamente aquí
+};
+
+// Trie compacto (radix) para búsquedas por prefijo
+class TrieCompacto {
+private:
+    NodoTrie raiz;
+
+    static size_t comun(const string& a, const string& b, size_t desde) {
+        size_t k = 0;
+        while (k < a.size() && desde + k < b.size() && a[k] == b[desde + k]) k++;
+        return k;
+    }
+
+    // un nodo sin valores y con un solo hijo se fusiona con él
+    static void fusionar(NodoTrie* n) {
+        if (!n->valores.empty() || n->hijos.size() != 1) return;
+        NodoTrie* hijo = n->hijos.begin()->second;
+        n->etiqueta += hijo->etiqueta;
+        n->hijos.swap(hijo->hijos);
+        n->valores.swap(hijo->valores);
+        hijo->hijos.clear();
+        delete hijo;
+    }
+
+    static void liberar(NodoTrie* n) {
+        for (auto& h : n->hijos) { liberar(h.second); delete h.second; }
+        n->hijos.clear();
+    }
+
+public:
+    ~TrieCompacto() { liberar(&raiz); }
+
+    void insertar(const string& clave, Nodo* valor) {
+        NodoTrie* nodo = &raiz;
+        size_t i = 0;
+        while (i < clave.size()) {
+            auto it = nodo->hijos.find(clave[i]);
+            if (it == nodo->hijos.end()) {
+                NodoTrie* hoja = new NodoTrie;
+                hoja->etiqueta = clave.substr(i);
+                hoja->valores.push_back(valor);
+                nodo->hijos[clave[i]] = hoja;
+                return;
+            }
+            NodoTrie* hijo = it->second;
+            size_t k = comun(hijo->etiqueta, clave, i);
+            if (k < hijo->etiqueta.size()) {
+                // partir la arista: nodo -> medio -> hijo
+                NodoTrie* medio = new NodoTrie;
+                medio->etiqueta = hijo->etiqueta.substr(0, k);
+                hijo->etiqueta.erase(0, k);
+                medio->hijos[hijo->etiqueta[0]] = hijo;
+                it->second = medio;
+                hijo = medio;
+            }
+            nodo = hijo;
+            i += k;
+        }
+        nodo->valores.push_back(valor);
+    }
+
+    void eliminar(const string& clave, Nodo* valor) {
+        NodoTrie* padre = nullptr;
+        NodoTrie* nodo = &raiz;
+        size_t i = 0;
+        while (i < clave.size()) {
+            auto it = nodo->hijos.find(clave[i]);
+            if (it == nodo->hijos.end()) return;
+            size_t k = comun(it->second->etiqueta, clave, i);
+            if (k < it->second->etiqueta.size()) return;
+            padre = nodo;
+            nodo = it->second;
+            i += k;
+        }
+        auto pos = find(nodo->valores.begin(), nodo->valores.end(), valor);
+        if (pos == nodo->valores.end()) return;
+        *pos = nodo->valores.back();
+        nodo->valores.pop_back();
+        if (!padre || !nodo->valores.empty()) return;
+
+        if (nodo->hijos.empty()) {
+            padre->hijos.erase(nodo->etiqueta[0]);
+            delete nodo;
+            if (padre != &raiz) fusionar(padre);
+        } else {
+            fusionar(nodo);
+        }
+    }
+
+    // Agrega a 'salida' los estudiantes cuya clave empieza con 'prefijo' (en orden alfabético)
+    void buscarPrefijo(const string& prefijo, vector<Nodo*>& salida) const {
+        const NodoTrie* nodo = &raiz;
+        size_t i = 0;
+        while (i < prefijo.size()) {
+            auto it = nodo->hijos.find(prefijo[i]);
+            if (it == nodo->hijos.end()) return;
+            size_t k = comun(it->second->etiqueta, prefijo, i);
+            nodo = it->second;
+            if (i + k == prefijo.size()) break;             // el prefijo termina dentro de esta arista
+            if (k < nodo->etiqueta.size()) return;
+            i += k;
+        }
+        // recorrido en profundidad del subárbol
+        vector<const NodoTrie*> pila(1, nodo);
+        while (!pila.empty()) {
+            const NodoTrie* n = pila.back();
+            pila.pop_back();
+            salida.insert(salida.end(), n->valores.begin(), n->valores.end());
+            for (auto it = n->hijos.rbegin(); it != n->hijos.rend(); ++it) pila.push_back(it->second);
+        }
+    }
+};
+
+// Índice invertido de n-gramas (de 1 a N caracteres) para búsquedas por subcadena. Cada lista es un
+// vector ordenado de números de estudiante (4 bytes por entrada): una consulta de hasta N caracteres
+// es una sola lista y las más largas intersectan las listas de todos sus trigramas
+class IndiceNGramas {
+public:
+    static const size_t N = 3;
+
+private:
+    unordered_map<uint32_t, vector<uint32_t>> listas;   // n-grama empaquetado -> números
+
+    // largo en el byte alto y los caracteres en los bytes bajos
+    static uint32_t empaquetar(const char* p, size_t n) {
+        uint32_t k = (uint32_t)n << 24;
+        for (size_t i = 0; i < n; ++i) k |= (uint32_t)(uint8_t)p[i] << (8 * (n - 1 - i));
+        return k;
+    }
+
+    // n-gramas distintos de la clave con largos desde..hasta (un estudiante aparece una sola vez por lista)
+    static void gramas(const string& clave, size_t desde, size_t hasta, vector<uint32_t>& salida) {
+        salida.clear();
+        for (size_t n = desde; n <= hasta; ++n)
+            for (size_t i = 0; i + n <= clave.size(); ++i) salida.push_back(empaquetar(clave.data() + i, n));
+        sort(salida.begin(), salida.end());
+        salida.erase(unique(salida.begin(), salida.end()), salida.end());
+    }
+
+    static void agregarOrdenado(vector<uint32_t>& v, uint32_t x) {
+        if (v.empty() || v.back() < x) v.push_back(x);   // lo común: números crecientes
+        else v.insert(lower_bound(v.begin(), v.end(), x), x);
+    }
+
+    // devuelve true si la lista quedó vacía
+    static bool quitarOrdenado(vector<uint32_t>& v, uint32_t x) {
+        auto it = lower_bound(v.begin(), v.end(), x);
+        if (it != v.end() && *it == x) v.erase(it);
+        return v.empty();
+    }
+
+public:
+    void insertar(const string& clave, uint32_t num) {
+        vector<uint32_t> gs;
+        gramas(clave, 1, N, gs);
+        for (uint32_t g : gs) agregarOrdenado(listas[g], num);
+    }
+
+    void eliminar(const string& clave, uint32_t num) {
+        vector<uint32_t> gs;
+        gramas(clave, 1, N, gs);
+        for (uint32_t g : gs) {
+            auto it = listas.find(g);
+            if (it != listas.end() && quitarOrdenado(it->second, num)) listas.erase(it);
+        }
+    }
+
+    // Candidatos para 'consulta', en orden de número. Hasta N caracteres la lista del n-grama ya es
+    // el resultado (exacta = true); si es más larga se intersectan las listas de todos sus trigramas,
+    // de la más corta a la más larga, y hay que verificar cada candidato
+    void candidatos(const string& consulta, vector<uint32_t>& salida, bool& exacta) const {
+        salida.clear();
+        exacta = consulta.size() <= N;
+        if (exacta) {
+            auto it = listas.find(empaquetar(consulta.data(), consulta.size()));
+            if (it != listas.end()) salida = it->second;
+            return;
+        }
+        vector<uint32_t> gs;
+        gramas(consulta, N, N, gs);
+        vector<const vector<uint32_t>*> ls;
+        for (uint32_t g : gs) {
+            auto it = listas.find(g);
+            if (it == listas.end()) return;
+            ls.push_back(&it->second);
+        }
+        sort(ls.begin(), ls.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+        salida = *ls[0];
+        for (size_t k = 1; k < ls.size() && !salida.empty(); ++k) {
+            size_t m = 0;
+            auto desde = ls[k]->begin();
+            for (uint32_t num : salida) {
+                desde = lower_bound(desde, ls[k]->end(), num);
+                if (desde == ls[k]->end()) break;
+                if (*desde == num) salida[m++] = num;
+            }
+            salida.resize(m);
+        }
+    }
+};
+
+// Índice de texto sobre un campo del estudiante: trie para prefijos y n-gramas para subcadenas.
+// Cada estudiante indexado recibe un número; su clave en minúsculas se guarda una sola vez
+// y con ella se verifican los candidatos sin volver a convertir el campo
+class IndiceTexto {
+private:
+    string Estudiante::* campo;
+    TrieCompacto trie;
+    IndiceNGramas ngramas;
+    vector<Nodo*> nodos;                       // número -> estudiante (nullptr si está libre)
+    vector<string> claves;                     // número -> clave en minúsculas
+    vector<uint32_t> libres;                   // números de estudiantes quitados, para reutilizar
+    unordered_map<const Nodo*, uint32_t> numero;
+
+public:
+    explicit IndiceTexto(string Estudiante::* c) : campo(c) {}
+
+    void agregar(Nodo* n) {
+        uint32_t num;
+        if (!libres.empty()) {
+            num = libres.back();
+            libres.pop_back();
+        } else {
+            num = (uint32_t)nodos.size();
+            nodos.push_back(nullptr);
+            claves.emplace_back();
+        }
+        nodos[num] = n;
+        claves[num] = minusculas(n->dato.*campo);
+        numero[n] = num;
+        trie.insertar(claves[num], n);
+        ngramas.insertar(claves[num], num);
+    }
+
+    void quitar(Nodo* n) {
+        auto it = numero.find(n);
+        if (it == numero.end()) return;
+        uint32_t num = it->second;
+        numero.erase(it);
+        trie.eliminar(claves[num], n);
+        ngramas.eliminar(claves[num], num);
+        nodos[num] = nullptr;
+        string().swap(claves[num]);
+        libres.push_back(num);
+    }
+
+    void buscarPrefijo(const string& prefijo, vector<Nodo*>& salida) const {
+        trie.buscarPrefijo(minusculas(prefijo), salida);
+    }
+
+    void buscarSubcadena(const string& texto, vector<Nodo*>& salida) const {
+        string consulta = minusculas(texto);
+        if (consulta.empty()) { trie.buscarPrefijo("", salida); return; }
+        vector<uint32_t> cand;
+        bool exacta;
+        ngramas.candidatos(consulta, cand, exacta);
+        for (uint32_t num : cand)
+            if (exacta || claves[num].find(consulta) != string::npos) salida.push_back(nodos[num]);
+    }
+};
+
+enum CampoTexto { CAMPO_NOMBRE, CAMPO_EMAIL };
+
+// Resumen de promedios de un grupo de estudiantes
+struct ResumenPromedio {
+    static const int CUBETAS = 10;      // histograma en cubetas de 0.5 sobre [0, 5]
+
+    int cantidad;
+    double media;
+    float minimo, maximo, mediana;
+    int histograma[CUBETAS];
+};
+
+// Agregados de 'promedio' mantenidos al insertar/eliminar, en total y por año de nacimiento.
+// Los valores de cada grupo viven en un árbol de estadísticos de orden (pb_ds de GCC), de modo
+// que mínimo, máximo y mediana siguen siendo O(log n) aunque se eliminen estudiantes.
+class AgregadosPromedio {
+private:
+    // clave (promedio, nodo): el nodo desempata promedios repetidos
+    typedef __gnu_pbds::tree<pair<float, const Nodo*>, __gnu_pbds::null_type, less<pair<float, const Nodo*>>,
+                             __gnu_pbds::rb_tree_tag, __gnu_pbds::tree_order_statistics_node_update> ArbolOrden;
+
+    struct Grupo {
+        double suma = 0;
+        ArbolOrden valores;
+        int histograma[ResumenPromedio::CUBETAS] = {};
+    };
+
+    Grupo total;
+    map<int, Grupo> porAno;
+
+    static int cubeta(float v) {
+        int c = (int)(v / 0.5f);
+        if (c < 0) c = 0;
+        if (c >= ResumenPromedio::CUBETAS) c = ResumenPromedio::CUBETAS - 1;  // 5.0 cae en la última
+        return c;
+    }
+
+    static void sumar(Grupo& g, const Nodo* n, int signo) {
+        float v = n->dato.promedio;
+        g.suma += signo * (double)v;
+        g.histograma[cubeta(v)] += signo;
+        if (signo > 0) g.valores.insert(make_pair(v, n));
+        else g.valores.erase(make_pair(v, n));
+    }
+
+    static ResumenPromedio resumir(const Grupo& g) {
+        ResumenPromedio r;
+        r.cantidad = (int)g.valores.size();
+        r.media = r.cantidad ? g.suma / r.cantidad : 0.0;
+        r.minimo = r.maximo = r.mediana = 0;
+        if (r.cantidad) {
+            r.minimo = g.valores.begin()->first;
+            r.maximo = g.valores.rbegin()->first;
+            int k = r.cantidad / 2;
+            r.mediana = g.valores.find_by_order(k)->first;
+            if (r.cantidad % 2 == 0) r.mediana = (r.mediana + g.valores.find_by_order(k - 1)->first) / 2;
+        }
+        for (int c = 0; c < ResumenPromedio::CUBETAS; ++c) r.histograma[c] = g.histograma[c];
+        return r;
+    }
+
+public:
+    void agregar(const Nodo* n) {
+        sumar(total, n, +1);
+        sumar(porAno[n->dato.anoNacimiento], n, +1);
+    }
+
+    void quitar(const Nodo* n) {
+        sumar(total, n, -1);
+        auto it = porAno.find(n->dato.anoNacimiento);
+        sumar(it->second, n, -1);
+        if (it->second.valores.empty()) porAno.erase(it);
+    }
+
+    ResumenPromedio resumen() const { return resumir(total); }
+
+    // Resumen de un año (cantidad 0 si no hay estudiantes de ese año)
+    ResumenPromedio resumenAno(int ano) const {
+        auto it = porAno.find(ano);
+        return it == porAno.end() ? resumir(Grupo()) : resumir(it->second);
+    }
+
+    vector<pair<int, ResumenPromedio>> resumenPorAno() const {
+        vector<pair<int, ResumenPromedio>> r;
+        r.reserve(porAno.size());
+        for (const auto& g : porAno) r.push_back(make_pair(g.first, resumir(g.second)));
+        return r;
+    }
+};
+
+class ListadoEstudiantil {
+private:
+    Nodo* cabeza;
+    Nodo* cola;     // último nodo: insertar (y reproducir el diario) no recorre la lista
+    int tamano;
+    DiarioEstudiantil* diario;  // si está adjunto, cada mutación se anota en el diario
+    IndiceTexto indiceNombre;   // se mantienen al insertar y eliminar
+    IndiceTexto indiceEmail;
+    AgregadosPromedio agregados;
+
+    void registrar(TipoRegistro tipo, const vector<char>& datos) {
+        if (diario) diario->anotar(tipo, datos);
+    }
+
+    void registrarEliminacion(int id) {
+        if (!diario) return;
+        vector<char> datos((char*)&id, (char*)&id + sizeof id);
+        registrar(REG_ELIMINAR, datos);
+    }
+
+public:
+    // Lista vacía al inicio
+    ListadoEstudiantil()
+        : cabeza(nullptr), cola(nullptr), tamano(0), diario(nullptr),
+          indiceNombre(&Estudiante::nombreCompleto), indiceEmail(&Estudiante::email) {}
+
+    // Las mutaciones posteriores se registran en d (la recuperación se hace antes de adjuntarlo)
+    void adjuntarDiario(DiarioEstudiantil* d) { diario = d; }
+
+    // Espera a que todas las mutaciones anotadas estén en disco
+    void sincronizar() { if (diario) diario->esperarTodo(); }
+
+    // Insertar al final
+    void insertar(const Estudiante& est) {
+        Nodo* nuevo = new Nodo(est);
+
+        if (!cabeza) {
+            cabeza = nuevo;
+        } else {
+            cola->siguiente = nuevo;
+        }
+        cola = nuevo;
+        tamano++;
+        indiceNombre.agregar(nuevo);
+        indiceEmail.agregar(nuevo);
+        agregados.agregar(nuevo);
+
+        if (diario) {
+            vector<char> datos;
+            DiarioEstudiantil::codificar(datos, est);
+            registrar(REG_INSERTAR, datos);
+        }
+    }
+
+    // Buscar estudiante por ID
+    int buscar(int id) {
+        Nodo* temp = cabeza;
+        int pos = 1;
+
+        while (temp) {
+            if (temp->dato.identificacion == id)
+                return pos;
+            temp = temp->siguiente;
+            pos++;
+        }
+        return -1;
+    }
+
+    // Eliminar estudiante por ID
+    bool eliminar(int id) {
+        if (!cabeza) return false;
+
+        // Eliminación de la cabeza
+        if (cabeza->dato.identificacion == id) {
+            Nodo* aux = cabeza;
+            cabeza = cabeza->siguiente;
+            if (!cabeza) cola = nullptr;
+            indiceNombre.quitar(aux);
+            indiceEmail.quitar(aux);
+            agregados.quitar(aux);
+            delete aux;
+            tamano--;
+            registrarEliminacion(id);
+            return true;
+        }
+
+        // Buscar nodo anterior
+        Nodo* temp = cabeza;
+        while (temp->siguiente &&
+               temp->siguiente->dato.identificacion != id)
+        {
+            temp = temp->siguiente;
+        }
+
+        if (!temp->siguiente) return false;
+
+        Nodo* eliminar = temp->siguiente;
+        temp->siguiente = eliminar->siguiente;
+        if (eliminar == cola) cola = temp;
+        indiceNombre.quitar(eliminar);
+        indiceEmail.quitar(eliminar);
+        agregados.quitar(eliminar);
+        delete eliminar;
+        tamano--;
+        registrarEliminacion(id);
+        return true;
+    }
+
+    // Estudiantes cuyo nombre o email empieza con 'prefijo' (sin distinguir mayúsculas)
+    vector<Estudiante> buscarPrefijo(const string& prefijo, CampoTexto campo) const {
+        vector<Nodo*> nodos;
+        (campo == CAMPO_NOMBRE ? indiceNombre : indiceEmail).buscarPrefijo(prefijo, nodos);
+        vector<Estudiante> r;
+        r.reserve(nodos.size());
+        for (Nodo* n : nodos) r.push_back(n->dato);
+        return r;
+    }
+
+    // Estudiantes cuyo nombre o email contiene 'texto' (sin distinguir mayúsculas)
+    vector<Estudiante> buscarSubcadena(const string& texto, CampoTexto campo) const {
+        vector<Nodo*> nodos;
+        (campo == CAMPO_NOMBRE ? indiceNombre : indiceEmail).buscarSubcadena(texto, nodos);
+        vector<Estudiante> r;
+        r.reserve(nodos.size());
+        for (Nodo* n : nodos) r.push_back(n->dato);
+        return r;
+    }
+
+    // Estadísticas de promedios (mantenidas al insertar y eliminar)
+    ResumenPromedio resumenPromedios() const { return agregados.resumen(); }
+    ResumenPromedio resumenPromediosAno(int ano) const { return agregados.resumenAno(ano); }
+    vector<pair<int, ResumenPromedio>> resumenPromediosPorAno() const { return agregados.resumenPorAno(); }
+
+    // Acceso por índice
+    Estudiante operator[](int index) {
+        if (index < 0 || index >= tamano) {
+            throw out_of_range("Índice fuera de rango");
+        }
+
+        Nodo* temp = cabeza;
+        for (int i = 0; i < index; i++)
+            temp = temp->siguiente;
+
+        return temp->dato;
+    }
+
+    // Imprimir lista completa en archivo TXT
+    void imprimirTXT() {
+        ofstream archivo("estudiantes.txt");
+
+        if (!archivo.is_open()) {
+            cout << "Error al crear archivo.\n";
+            return;
+        }
+
+        Nodo* temp = cabeza;
+        archivo << "===== LISTADO DE ESTUDIANTES =====\n\n";
+
+        while (temp) {
+            archivo << "Nombre: " << temp->dato.nombreCompleto << "\n";
+            archivo << "Año nacimiento: " << temp->dato.anoNacimiento << "\n";
+            archivo << "ID: " << temp->dato.identificacion << "\n";
+            archivo << "Promedio: " << temp->dato.promedio << "\n";
+            archivo << "Email: " << temp->dato.email << "\n";
+            archivo << "----------------------------------\n";
+            temp = temp->siguiente;
+        }
+
+        archivo.close();
+        cout << "Archivo 'estudiantes.txt' generado correctamente.\n";
+    }
+
+    // Invertir la lista
+    void invertir() {
+        Nodo* prev = nullptr;
+        Nodo* actual = cabeza;
+        Nodo* siguiente = nullptr;
+        cola = cabeza;
+
+        while (actual) {
+            siguiente = actual->siguiente;
+            actual->siguiente = prev;
+            prev = actual;
+            actual = siguiente;
+        }
+
+        cabeza = prev;
+        registrar(REG_INVERTIR, vector<char>());
+    }
+
+    // Copia de todos los estudiantes en orden (para la copia completa del diario)
+    vector<Estudiante> copia() const {
+        vector<Estudiante> v;
+        v.reserve(tamano);
+        for (Nodo* temp = cabeza; temp; temp = temp->siguiente) v.push_back(temp->dato);
+        return v;
+    }
+
+    // Liberar memoria
+    ~ListadoEstudiantil() {
+        Nodo* temp;
+        while (cabeza) {
+            temp = cabeza;
+            cabeza = cabeza->siguiente;
+            delete temp;
+        }
+    }
+
+    int size() { return tamano; }
+};
+
+inline bool DiarioEstudiantil::abrir(ListadoEstudiantil& lista, size_t& recuperados) {
+    recuperados = 0;
+    // copia completa más reciente que esté íntegra
+    vector<uint64_t> gens;
+    error_code ec;
+    filesystem::path dir = filesystem::path(base).parent_path();
+    string prefijo = filesystem::path(base).filename().string() + ".";
+    uint64_t gen;
+    string sufijo;
+    for (const auto& ent : filesystem::directory_iterator(dir.empty() ? "." : dir, ec))
+        if (nombreGeneracion(ent.path().filename().string(), prefijo, gen, sufijo) && sufijo == ".snap")
+            gens.push_back(gen);
+    sort(gens.rbegin(), gens.rend());
+    uint64_t s = 0;
+    vector<Estudiante> ests;
+    for (uint64_t g : gens) {
+        if (!leerSnapshot(g, ests, bytesCopia)) continue;
+        for (const auto& e : ests) lista.insertar(e);
+        s = g;
+        break;
+    }
+    generacionCopia = s;
+
+    // reproducir los diarios s, s+1, ...
+    uint64_t g = s;
+    bool hayDiario = false;
+    size_t validos = 0;
+    vector<char> b;
+    while (leerArchivo(nombreDiario(g), b) && reproducirDiario(b, g, lista, validos, recuperados)) {
+        if (validos < b.size()) filesystem::resize_file(nombreDiario(g), validos, ec);  // descarta la cola rota
+        hayDiario = true;
+        ++g;
+    }
+
+    if (hayDiario) {
+        generacion = g - 1;
+        archivo = fopen(nombreDiario(generacion).c_str(), "ab");
+        bytesDiario = validos;
+    } else {
+        generacion = s;
+        archivo = crearDiario(s);
+        bytesDiario = 12;
+    }
+    if (!archivo) return false;
+    borrarViejos(s);
+    escritor = thread(&DiarioEstudiantil::bucleEscritor, this);
+    return true;
+}
+
+#endif // LISTADO_ESTUDIANTIL_H
@@ -0,0 +1,867 @@
+// Señal ECG en lista doble: archivo comprimido .ecgz, filtros, detección de picos en paralelo y grafo de etapas con caché.
+// Lo usan codigo2.cpp y benchmark.cpp.
+#ifndef SENAL_ECG_H
+#define SENAL_ECG_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <iomanip>
+
+using namespace std;
+
+// Nodo de la lista doble: guarda tiempo, amplitud y valor filtrado (NodoSenal para no chocar con el Nodo del listado)
+struct NodoSenal {
+    double tiempo;
+    double amplitud;
+    double filtrada;
+    NodoSenal* sig;
+    NodoSenal* ant;
+
+    NodoSenal(double t = 0.0, double a = 0.0)
+        : tiempo(t), amplitud(a), filtrada(0.0), sig(nullptr), ant(nullptr) {}
+};
+
+// Archivo comprimido sin pérdida de muestras cuantizadas (".ecgz").
+// Cada muestra se guarda como entero: amplitud * divisorAmp y tiempo * divisorTiempo redondeados
+// (con divisor 1000 una amplitud escrita con 3 decimales vuelve exactamente igual). Las muestras se
+// agrupan en bloques independientes; en cada bloque se predice la muestra con la anterior
+// (orden 1) o con 2*x[i-1] - x[i-2] (orden 2, se elige el que ocupe menos) y se guarda el residuo
+// en zig-zag + varint. Si el tiempo del bloque es uniforme solo se guardan t0 y dt.
+// Formato:
+//   cabecera: "ECGZ", versión u32, divisorAmp f64, divisorTiempo f64, muestras u64,
+//             muestrasPorBloque u32, bloques u32, posición del índice u64
+//   bloque:   banderas u8, residuos de tiempo, residuos de amplitud, fnv1a u32 del bloque
+//   índice:   por bloque, posición u64 y tiempo inicial f64 (para saltar por tiempo)
+class ArchivoECG {
+public:
+    static const uint32_t MUESTRAS_POR_BLOQUE = 4096;
+
+private:
+    enum { TIEMPO_UNIFORME = 1, AMP_ORDEN2 = 2 };
+    static const size_t CABECERA = 4 + 4 + 8 + 8 + 8 + 4 + 4 + 8;
+
+    string nombre;
+    double divAmp, divTiempo;
+    uint64_t muestras;
+    uint32_t porBloque;
+    vector<uint64_t> posiciones;    // posición de cada bloque (y del índice, al final)
+    vector<double> tiemposIniciales;
+
+    static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+    static int64_t deszigzag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+    static void ponerVarint(vector<uint8_t>& b, uint64_t v) {
+        while (v >= 0x80) { b.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+        b.push_back((uint8_t)v);
+    }
+    static bool leerVarint(const uint8_t*& p, const uint8_t* fin, uint64_t& v) {
+        v = 0;
+        for (int corr = 0; corr < 64 && p < fin; corr += 7) {
+            uint8_t c = *p++;
+            v |= (uint64_t)(c & 0x7f) << corr;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Lee n residuos. Camino rápido (SWAR): si 8 bytes seguidos no tienen bit de continuación,
+    // son 8 residuos de un byte y se decodifican sin ramas por byte
+    static bool leerResiduos(const uint8_t*& p, const uint8_t* fin, int64_t* r, size_t n) {
+        size_t i = 0;
+        while (i < n) {
+            if (n - i >= 8 && fin - p >= 8) {
+                uint64_t w;
+                memcpy(&w, p, 8);
+                if ((w & 0x8080808080808080ULL) == 0) {
+                    for (int j = 0; j < 8; j++) r[i + j] = deszigzag((w >> (8 * j)) & 0xff);
+                    p += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+            uint64_t u;
+            if (!leerVarint(p, fin, u)) return false;
+            r[i++] = deszigzag(u);
+        }
+        return true;
+    }
+
+    static uint32_t fnv1a(const uint8_t* p, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 16777619u; }
+        return h;
+    }
+
+    // residuos de x con predictor de orden 1 u 2 (el primero es el valor completo)
+    static void residuos(const vector<int64_t>& x, bool orden2, vector<uint8_t>& b) {
+        for (size_t i = 0; i < x.size(); i++) {
+            int64_t pred = i == 0 ? 0 : (i == 1 || !orden2) ? x[i - 1] : 2 * x[i - 1] - x[i - 2];
+            ponerVarint(b, zigzag(x[i] - pred));
+        }
+    }
+
+    static void integrar(int64_t* x, size_t n, bool orden2) {
+        for (size_t i = 1; i < n; i++)
+            x[i] += (i == 1 || !orden2) ? x[i - 1] : 2 * x[i - 1] - x[i - 2];
+    }
+
+    static void codificarBloque(const double* t, const double* a, size_t n, double divA, double divT,
+                                vector<uint8_t>& b) {
+        vector<int64_t> qt(n), qa(n);
+        for (size_t i = 0; i < n; i++) {
+            qt[i] = llround(t[i] * divT);
+            qa[i] = llround(a[i] * divA);
+        }
+        bool uniforme = true;
+        for (size_t i = 2; i < n && uniforme; i++) uniforme = qt[i] - qt[i - 1] == qt[1] - qt[0];
+
+        vector<uint8_t> o1, o2;
+        residuos(qa, false, o1);
+        residuos(qa, true, o2);
+        bool orden2 = o2.size() < o1.size();
+
+        size_t ini = b.size();
+        b.push_back((uint8_t)((uniforme ? TIEMPO_UNIFORME : 0) | (orden2 ? AMP_ORDEN2 : 0)));
+        if (uniforme) {
+            ponerVarint(b, zigzag(n ? qt[0] : 0));
+            ponerVarint(b, zigzag(n > 1 ? qt[1] - qt[0] : 0));
+        } else {
+            residuos(qt, true, b);
+        }
+        const vector<uint8_t>& ra = orden2 ? o2 : o1;
+        b.insert(b.end(), ra.begin(), ra.end());
+        uint32_t h = fnv1a(b.data() + ini, b.size() - ini);
+        b.insert(b.end(), (uint8_t*)&h, (uint8_t*)&h + 4);
+    }
+
+public:
+    ArchivoECG() : divAmp(1000), divTiempo(1e6), muestras(0), porBloque(MUESTRAS_POR_BLOQUE) {}
+
+    // Escribe las muestras; divAmp = unidades de cuantización por unidad de amplitud
+    static bool escribir(const string& archivo, const vector<double>& t, const vector<double>& a,
+                         double divA = 1000, double divT = 1e6) {
+        ofstream ofs(archivo, ios::binary);
+        if (!ofs.is_open()) return false;
+        uint64_t n = t.size();
+        uint32_t B = MUESTRAS_POR_BLOQUE, bloques = (uint32_t)((n + B - 1) / B), version = 1;
+        vector<uint8_t> cab(CABECERA, 0);
+        ofs.write((const char*)cab.data(), cab.size());   // se reescribe al final
+
+        vector<uint64_t> pos;
+        vector<double> t0;
+        vector<uint8_t> b;
+        uint64_t offset = CABECERA;
+        for (uint32_t k = 0; k < bloques; k++) {
+            size_t ini = (size_t)k * B, cnt = min<size_t>(B, n - ini);
+            b.clear();
+            codificarBloque(&t[ini], &a[ini], cnt, divA, divT, b);
+            ofs.write((const char*)b.data(), b.size());
+            pos.push_back(offset);
+            t0.push_back(t[ini]);
+            offset += b.size();
+        }
+        for (uint32_t k = 0; k < bloques; k++) {
+            ofs.write((const char*)&pos[k], 8);
+            ofs.write((const char*)&t0[k], 8);
+        }
+
+        uint8_t* p = cab.data();
+        memcpy(p, "ECGZ", 4); p += 4;
+        memcpy(p, &version, 4); p += 4;
+        memcpy(p, &divA, 8); p += 8;
+        memcpy(p, &divT, 8); p += 8;
+        memcpy(p, &n, 8); p += 8;
+        memcpy(p, &B, 4); p += 4;
+        memcpy(p, &bloques, 4); p += 4;
+        memcpy(p, &offset, 8);
+        ofs.seekp(0);
+        ofs.write((const char*)cab.data(), cab.size());
+        return (bool)ofs;
+    }
+
+    // Lee la cabecera y el índice (los bloques se leen a pedido)
+    bool abrir(const string& archivo) {
+        ifstream ifs(archivo, ios::binary);
+        uint8_t cab[CABECERA];
+        if (!ifs.read((char*)cab, CABECERA) || memcmp(cab, "ECGZ", 4) != 0) return false;
+        uint32_t version, bloques;
+        uint64_t posIndice;
+        const uint8_t* p = cab + 4;
+        memcpy(&version, p, 4); p += 4;
+        memcpy(&divAmp, p, 8); p += 8;
+        memcpy(&divTiempo, p, 8); p += 8;
+        memcpy(&muestras, p, 8); p += 8;
+        memcpy(&porBloque, p, 4); p += 4;
+        memcpy(&bloques, p, 4); p += 4;
+        memcpy(&posIndice, p, 8);
+        if (version != 1 || porBloque == 0 || bloques != (muestras + porBloque - 1) / porBloque) return false;
+
+        posiciones.assign(bloques + 1, posIndice);
+        tiemposIniciales.assign(bloques, 0.0);
+        ifs.seekg(posIndice);
+        for (uint32_t k = 0; k < bloques; k++) {
+            if (!ifs.read((char*)&posiciones[k], 8) || !ifs.read((char*)&tiemposIniciales[k], 8)) return false;
+            if (posiciones[k] < CABECERA || posiciones[k] > posIndice || (k && posiciones[k] < posiciones[k - 1]))
+                return false;
+        }
+        nombre = archivo;
+        return true;
+    }
+
+    uint64_t numMuestras() const { return muestras; }
+    uint32_t numBloques() const { return (uint32_t)tiemposIniciales.size(); }
+    uint32_t muestrasPorBloque() const { return porBloque; }
+    uint64_t posicionBloque(uint32_t k) const { return posiciones[k]; }
+
+    // Bloque que contiene el tiempo t (búsqueda binaria en el índice)
+    uint32_t bloqueDeTiempo(double t) const {
+        size_t k = upper_bound(tiemposIniciales.begin(), tiemposIniciales.end(), t) - tiemposIniciales.begin();
+        return k ? (uint32_t)(k - 1) : 0;
+    }
+
+    // Decodifica el bloque k ya leído en memoria directamente en t y a (n muestras)
+    bool decodificarBloque(uint32_t k, const uint8_t* datos, size_t bytes, double* t, double* a) const {
+        size_t n = min<uint64_t>(porBloque, muestras - (uint64_t)k * porBloque);
+        if (bytes < 5) return false;
+        uint32_t h;
+        memcpy(&h, datos + bytes - 4, 4);
+        if (fnv1a(datos, bytes - 4) != h) return false;
+        const uint8_t* p = datos;
+        const uint8_t* fin = datos + bytes - 4;
+        uint8_t banderas = *p++;
+
+        vector<int64_t> x(n);
+        if (banderas & TIEMPO_UNIFORME) {
+            uint64_t u0, ud;
+            if (!leerVarint(p, fin, u0) || !leerVarint(p, fin, ud)) return false;
+            int64_t q0 = deszigzag(u0), dq = deszigzag(ud);
+            for (size_t i = 0; i < n; i++) t[i] = (double)(q0 + (int64_t)i * dq) / divTiempo;
+        } else {
+            if (!leerResiduos(p, fin, x.data(), n)) return false;
+            integrar(x.data(), n, true);
+            for (size_t i = 0; i < n; i++) t[i] = (double)x[i] / divTiempo;
+        }
+        if (!leerResiduos(p, fin, x.data(), n)) return false;
+        integrar(x.data(), n, (banderas & AMP_ORDEN2) != 0);
+        for (size_t i = 0; i < n; i++) a[i] = (double)x[i] / divAmp;
+        return p == fin;
+    }
+
+    // Decodifica las muestras [desde, desde + cantidad) leyendo solo los bloques necesarios
+    bool leer(uint64_t desde, uint64_t cantidad, vector<double>& t, vector<double>& a) const {
+        if (desde > muestras) return false;
+        cantidad = min(cantidad, muestras - desde);
+        t.resize(cantidad);
+        a.resize(cantidad);
+        if (!cantidad) return true;
+        // una sola lectura para todos los bloques del rango
+        uint32_t k0 = (uint32_t)(desde / porBloque), k1 = (uint32_t)((desde + cantidad - 1) / porBloque);
+        ifstream ifs(nombre, ios::binary);
+        vector<uint8_t> datos(posiciones[k1 + 1] - posiciones[k0]);
+        ifs.seekg(posiciones[k0]);
+        if (!ifs.read((char*)datos.data(), datos.size())) return false;
+        vector<double> bt(porBloque), ba(porBloque);
+        for (uint32_t k = k0; k <= k1; k++) {
+            size_t bytes = posiciones[k + 1] - posiciones[k];
+            const uint8_t* bloque = datos.data() + (posiciones[k] - posiciones[k0]);
+            uint64_t ini = (uint64_t)k * porBloque;
+            size_t n = min<uint64_t>(porBloque, muestras - ini);
+            // los bloques completos se decodifican directo en la salida
+            bool completo = ini >= desde && ini + n <= desde + cantidad;
+            double* dt = completo ? &t[ini - desde] : bt.data();
+            double* da = completo ? &a[ini - desde] : ba.data();
+            if (!decodificarBloque(k, bloque, bytes, dt, da)) return false;
+            if (!completo) {
+                uint64_t de = max(desde, ini), hasta = min(desde + cantidad, ini + n);
+                copy(bt.begin() + (de - ini), bt.begin() + (hasta - ini), t.begin() + (de - desde));
+                copy(ba.begin() + (de - ini), ba.begin() + (hasta - ini), a.begin() + (de - desde));
+            }
+        }
+        return true;
+    }
+};
+
+// Grupo fijo de hilos para repartir trozos de una misma señal
+class PoolHilos {
+private:
+    vector<thread> trabajadores;
+    mutex mtx;
+    condition_variable hayTarea, terminado;
+    const function<void(size_t)>* tarea;
+    size_t total, siguiente, pendientes;
+    uint64_t generacion;
+    bool detener;
+
+    // toma índices libres hasta agotarlos (se llama con el candado tomado)
+    void trabajar(unique_lock<mutex>& lk) {
+        while (tarea && siguiente < total) {
+            size_t i = siguiente++;
+            const function<void(size_t)>* f = tarea;
+            lk.unlock();
+            (*f)(i);
+            lk.lock();
+            if (--pendientes == 0) terminado.notify_all();
+        }
+    }
+
+    void bucle() {
+        unique_lock<mutex> lk(mtx);
+        uint64_t visto = 0;
+        while (true) {
+            hayTarea.wait(lk, [&] { return detener || (generacion != visto && tarea && siguiente < total); });
+            if (detener) return;
+            visto = generacion;
+            trabajar(lk);
+        }
+    }
+
+public:
+    explicit PoolHilos(unsigned n)
+        : tarea(nullptr), total(0), siguiente(0), pendientes(0), generacion(0), detener(false) {
+        // el hilo que llama a paraCada también trabaja
+        for (unsigned i = 1; i < n; ++i) trabajadores.emplace_back(&PoolHilos::bucle, this);
+    }
+
+    ~PoolHilos() {
+        {
+            lock_guard<mutex> lk(mtx);
+            detener = true;
+        }
+        hayTarea.notify_all();
+        for (auto& t : trabajadores) t.join();
+    }
+
+    unsigned tamano() const { return (unsigned)trabajadores.size() + 1; }
+
+    // Ejecuta f(0), ..., f(n-1) repartidos entre los hilos; vuelve cuando terminan todas
+    void paraCada(size_t n, const function<void(size_t)>& f) {
+        unique_lock<mutex> lk(mtx);
+        tarea = &f;
+        total = n;
+        siguiente = 0;
+        pendientes = n;
+        ++generacion;
+        hayTarea.notify_all();
+        trabajar(lk);
+        terminado.wait(lk, [&] { return pendientes == 0; });
+        tarea = nullptr;
+    }
+};
+
+// Pool compartido, con un hilo por núcleo
+inline PoolHilos& poolGlobal() {
+    static PoolHilos pool(max(1u, thread::hardware_concurrency()));
+    return pool;
+}
+
+// Frecuencia cardíaca y variabilidad (HRV) a partir de los intervalos RR
+struct ResumenRitmo {
+    size_t latidos;
+    double bpm;         // 60 / RR promedio
+    double rrMedio;     // s
+    double sdnn;        // desviación estándar de RR (s)
+    double rmssd;       // raíz del promedio de diferencias sucesivas al cuadrado (s)
+    double pnn50;       // % de diferencias sucesivas mayores a 50 ms
+};
+
+// Clase que maneja la señal ECG usando lista doble enlazada
+class SenalECG {
+public:
+    // Etapas del grafo de procesamiento (para consultar cuántas veces se calculó cada una)
+    enum Etapa { ETAPA_FILTRO, ETAPA_NIVEL, ETAPA_PICOS, ETAPA_RITMO, NUM_ETAPAS };
+
+private:
+    NodoSenal* inicio;
+    NodoSenal* fin;
+    size_t tam;
+    unsigned hilos;     // 0 = uno por núcleo, 1 = todo en serie
+
+    // Grafo de etapas: cruda -> filtrada -> nivel (RMS y máximos locales) -> picos -> RR -> BPM/HRV.
+    // Cada etapa guarda la clave con que se calculó (sus parámetros y la versión de la etapa de
+    // la que depende); si la clave coincide se reutiliza y si no se recalcula solo esa etapa.
+    // La versión 0 significa "nunca calculada".
+    enum TipoFiltro { FILTRO_IIR, FILTRO_FIR };
+
+    uint64_t verCruda;      // sube al insertar muestras
+    uint64_t verFiltrada;   // sube cada vez que cambia el campo 'filtrada' de algún nodo
+
+    struct EtapaFiltro {
+        TipoFiltro tipo;
+        double parametro;
+        uint64_t verCruda;
+    } filtro;
+
+    // depende solo de la señal filtrada: sirve para cualquier umbral y refractario
+    struct EtapaNivel {
+        uint64_t verFiltrada;
+        double sum2, maxAbs;
+        size_t n;
+        vector<vector<double>> tiempos, valores;   // máximos locales de cada trozo
+    } nivel;
+
+    struct EtapaPicos {
+        uint64_t verFiltrada;
+        double umbral, refractario;
+        uint64_t version;
+        vector<double> tiempos;
+    } picos;
+
+    struct EtapaRitmo {
+        uint64_t verPicos;
+        vector<double> rr;
+        ResumenRitmo resumen;
+    } ritmo;
+
+    size_t calculos[NUM_ETAPAS];
+
+    // señales cortas no se parten: el costo de repartir supera la ganancia
+    static const size_t MIN_TROZO = 1 << 14;
+
+    size_t numTrozos() const {
+        unsigned h = hilos ? hilos : poolGlobal().tamano();
+        if (h <= 1 || tam < 2 * MIN_TROZO) return 1;
+        return min((size_t)h * 4, tam / MIN_TROZO);   // varios trozos por hilo para equilibrar la carga
+    }
+
+    static void ejecutar(size_t trozos, const function<void(size_t)>& f) {
+        if (trozos == 1) f(0);
+        else poolGlobal().paraCada(trozos, f);
+    }
+
+    bool filtroVigente(TipoFiltro tipo, double parametro) const {
+        return filtro.verCruda == verCruda && filtro.tipo == tipo && filtro.parametro == parametro;
+    }
+
+    void filtroCalculado(TipoFiltro tipo, double parametro) {
+        filtro.tipo = tipo;
+        filtro.parametro = parametro;
+        filtro.verCruda = verCruda;
+        verFiltrada++;
+        calculos[ETAPA_FILTRO]++;
+    }
+
+    // RMS y máximo absoluto (pasada en serie: el orden de la suma fija el umbral exacto) y,
+    // en paralelo por trozos, los máximos locales y > vecinos (el halo es el vecino de cada borde)
+    void asegurarNivel() {
+        if (nivel.verFiltrada == verFiltrada) return;
+
+        size_t trozos = numTrozos();
+        size_t paso = (tam + trozos - 1) / trozos;
+        vector<NodoSenal*> inicios;
+        inicios.reserve(trozos);
+
+        double sum2 = 0, maxAbs = 0;
+        size_t n = 0;
+
+        for (NodoSenal* p = inicio; p; p = p->sig) {
+            if (n % paso == 0) inicios.push_back(p);
+            double v = fabs(p->filtrada);
+            sum2 += v * v;
+            maxAbs = max(maxAbs, v);
+            n++;
+        }
+
+        nivel.tiempos.assign(inicios.size(), vector<double>());
+        nivel.valores.assign(inicios.size(), vector<double>());
+        ejecutar(inicios.size(), [&](size_t t) {
+            size_t a = max<size_t>(t * paso, 1);
+            size_t b = min(tam - 1, (t + 1) * paso);
+            NodoSenal* cur = inicios[t];
+            if (t == 0) cur = cur->sig;
+            for (size_t i = a; i < b; i++, cur = cur->sig) {
+                double y = cur->filtrada;
+                if (y > cur->ant->filtrada && y > cur->sig->filtrada) {
+                    nivel.tiempos[t].push_back(cur->tiempo);
+                    nivel.valores[t].push_back(y);
+                }
+            }
+        });
+
+        nivel.sum2 = sum2;
+        nivel.maxAbs = maxAbs;
+        nivel.n = n;
+        nivel.verFiltrada = verFiltrada;
+        calculos[ETAPA_NIVEL]++;
+    }
+
+    // Etapa de picos: la deja al día para este umbral y refractario, sin copiarla ni imprimir.
+    // Usa la etapa de nivel (RMS y máximos locales, que no dependen del umbral ni del refractario).
+    // Cada trozo filtra sus máximos por umbral en paralelo y aplica el periodo refractario como si
+    // empezara solo. Al unir los trozos en orden se rehace la cadena refractaria desde el último pico
+    // aceptado hasta que coincide con la del trozo; desde ahí es la misma, así que el resultado es
+    // idéntico al recorrido en serie. Con la misma señal, umbral y refractario no se recalcula.
+    // Requiere tam >= 3
+    void asegurarPicos(double umbralMin, double refractario_seg) {
+        asegurarNivel();
+        double rms = (nivel.n > 0 ? sqrt(nivel.sum2 / nivel.n) : 0);
+        double umbral = max(umbralMin, rms * 1.2);
+        if (nivel.maxAbs > 0 && umbral > 0.9 * nivel.maxAbs) umbral = 0.6 * nivel.maxAbs;
+
+        if (picos.verFiltrada != verFiltrada || picos.umbral != umbral || picos.refractario != refractario_seg) {
+            size_t trozos = nivel.tiempos.size();
+            vector<double> tiempos;
+            vector<vector<double>> candidatos(trozos);
+            vector<vector<char>> aceptados(trozos);   // cadena refractaria local de cada trozo
+            ejecutar(trozos, [&](size_t t) {
+                const vector<double>& ts = nivel.tiempos[t];
+                const vector<double>& ys = nivel.valores[t];
+                double ultimo = -1e9;
+                for (size_t i = 0; i < ts.size(); i++) {
+                    if (fabs(ys[i]) >= umbral) {
+                        bool acepta = ts[i] - ultimo >= refractario_seg;
+                        candidatos[t].push_back(ts[i]);
+                        aceptados[t].push_back(acepta);
+                        if (acepta) ultimo = ts[i];
+                    }
+                }
+            });
+
+            double ultimo = -1e9;
+            for (size_t t = 0; t < trozos; t++) {
+                const vector<double>& c = candidatos[t];
+                size_t k = 0;
+                // hasta sincronizar con la cadena local
+                while (k < c.size()) {
+                    bool sincronizado = false;
+                    if (c[k] - ultimo >= refractario_seg) {
+                        tiempos.push_back(c[k]);
+                        ultimo = c[k];
+                        sincronizado = aceptados[t][k];
+                    }
+                    k++;
+                    if (sincronizado) break;
+                }
+                for (; k < c.size(); k++)
+                    if (aceptados[t][k]) { tiempos.push_back(c[k]); ultimo = c[k]; }
+            }
+
+            picos.tiempos.swap(tiempos);
+            picos.verFiltrada = verFiltrada;
+            picos.umbral = umbral;
+            picos.refractario = refractario_seg;
+            picos.version++;
+            calculos[ETAPA_PICOS]++;
+        }
+    }
+
+    void asegurarRitmo() {
+        if (ritmo.verPicos == picos.version) return;
+        const vector<double>& p = picos.tiempos;
+        ResumenRitmo& r = ritmo.resumen;
+        r = ResumenRitmo{p.size(), 0, 0, 0, 0, 0};
+        ritmo.rr.clear();
+        for (size_t i = 1; i < p.size(); i++) ritmo.rr.push_back(p[i] - p[i - 1]);
+
+        if (p.size() >= 2) {
+            double sumaRR = 0;
+            for (double x : ritmo.rr) sumaRR += x;
+            double rr_prom = sumaRR / (p.size() - 1);
+            r.rrMedio = rr_prom;
+            r.bpm = (rr_prom > 0 ? 60.0 / rr_prom : 0);
+
+            double var = 0, dif2 = 0;
+            size_t mayores50 = 0;
+            for (size_t i = 0; i < ritmo.rr.size(); i++) {
+                var += (ritmo.rr[i] - rr_prom) * (ritmo.rr[i] - rr_prom);
+                if (i) {
+                    double d = ritmo.rr[i] - ritmo.rr[i - 1];
+                    dif2 += d * d;
+                    if (fabs(d) > 0.05) mayores50++;
+                }
+            }
+            if (ritmo.rr.size() > 1) {
+                r.sdnn = sqrt(var / (ritmo.rr.size() - 1));
+                r.rmssd = sqrt(dif2 / (ritmo.rr.size() - 1));
+                r.pnn50 = 100.0 * mayores50 / (ritmo.rr.size() - 1);
+            }
+        }
+        ritmo.verPicos = picos.version;
+        calculos[ETAPA_RITMO]++;
+    }
+
+public:
+    // Lista vacía
+    SenalECG() : inicio(nullptr), fin(nullptr), tam(0), hilos(0), verCruda(1), verFiltrada(1) {
+        filtro.tipo = FILTRO_IIR;
+        filtro.parametro = 0;
+        picos.umbral = picos.refractario = 0;
+        invalidarCache();
+        picos.version = 0;
+        for (int e = 0; e < NUM_ETAPAS; e++) calculos[e] = 0;
+    }
+
+    // Descarta todos los resultados guardados (la próxima consulta recalcula cada etapa)
+    void invalidarCache() {
+        filtro.verCruda = 0;
+        nivel.verFiltrada = 0;
+        picos.verFiltrada = 0;
+        ritmo.verPicos = 0;
+    }
+
+    // Veces que se calculó cada etapa (las consultas repetidas no cuentan)
+    size_t numCalculos(Etapa e) const { return calculos[e]; }
+
+    // Cantidad de hilos para filtrar y detectar picos (0 = automático, 1 = en serie).
+    // El resultado es idéntico bit a bit con cualquier cantidad
+    void usarHilos(unsigned n) { hilos = n; }
+
+    // Liberamos memoria al terminar
+    ~SenalECG() {
+        NodoSenal* cur = inicio;
+        while (cur) {
+            NodoSenal* tmp = cur;
+            cur = cur->sig;
+            delete tmp;
+        }
+    }
+
+    // Insertar muestra al final
+    void insertar(double t, double a) {
+        NodoSenal* n = new NodoSenal(t, a);
+        if (!inicio) {
+            inicio = fin = n;
+        } else {
+            fin->sig = n;
+            n->ant = fin;
+            fin = n;
+        }
+        tam++;
+        verCruda++;
+        verFiltrada++;      // el nodo nuevo trae filtrada = 0
+    }
+
+    // Cargar datos desde archivo (texto "t a" por línea, o comprimido .ecgz)
+    bool cargarDesdeArchivo(const string& nombreArchivo) {
+        ifstream ifs(nombreArchivo);
+        if (!ifs.is_open()) {
+            cerr << "Error abriendo archivo.\n";
+            return false;
+        }
+        char magia[4] = {};
+        if (ifs.read(magia, 4) && memcmp(magia, "ECGZ", 4) == 0) return cargarComprimido(nombreArchivo);
+        ifs.clear();
+        ifs.seekg(0);
+
+        double t, a;
+        size_t cont = 0;
+
+        while (ifs >> t >> a) {
+            insertar(t, a);
+            cont++;
+        }
+        ifs.close();
+
+        if (cont == 0) {
+            cerr << "Archivo vacío.\n";
+            return false;
+        }
+
+        cout << "Leídas " << cont << " muestras.\n";
+        return true;
+    }
+
+    size_t size() const { return tam; }
+
+    // Carga un archivo .ecgz: se decodifica todo en buffers y luego se arma la lista
+    bool cargarComprimido(const string& nombreArchivo) {
+        ArchivoECG arch;
+        vector<double> t, a;
+        if (!arch.abrir(nombreArchivo) || !arch.leer(0, arch.numMuestras(), t, a)) {
+            cerr << "Archivo comprimido inválido o dañado.\n";
+            return false;
+        }
+        if (t.empty()) {
+            cerr << "Archivo vacío.\n";
+            return false;
+        }
+        for (size_t i = 0; i < t.size(); i++) insertar(t[i], a[i]);
+        cout << "Leídas " << t.size() << " muestras.\n";
+        return true;
+    }
+
+    // Guarda las muestras originales comprimidas; divisorAmp = niveles por unidad de amplitud
+    // (1000 conserva exactamente amplitudes con 3 decimales)
+    bool guardarComprimido(const string& nombreSalida, double divisorAmp = 1000) const {
+        vector<double> t, a;
+        t.reserve(tam);
+        a.reserve(tam);
+        double errorMax = 0;
+        for (NodoSenal* p = inicio; p; p = p->sig) {
+            t.push_back(p->tiempo);
+            a.push_back(p->amplitud);
+            errorMax = max(errorMax, fabs(llround(p->amplitud * divisorAmp) / divisorAmp - p->amplitud));
+        }
+        if (!ArchivoECG::escribir(nombreSalida, t, a, divisorAmp)) {
+            cerr << "Error guardando archivo.\n";
+            return false;
+        }
+        ifstream f(nombreSalida, ios::binary | ios::ate);
+        double bytes = (double)f.tellg();
+        cout << "Archivo comprimido guardado: " << bytes / max<size_t>(tam, 1) << " bytes por muestra";
+        if (errorMax > 0) cout << " (error de cuantización máx. " << errorMax << ")";
+        cout << ".\n";
+        return true;
+    }
+
+    // Filtro IIR simple (no se recalcula si la señal y alpha no cambiaron)
+    void filtroIIR(double alpha = 0.98) {
+        if (!inicio) return;
+        if (alpha < 0) alpha = 0;
+        if (alpha > 1) alpha = 1;
+        if (filtroVigente(FILTRO_IIR, alpha)) { cout << "Filtro IIR aplicado.\n"; return; }
+
+        inicio->filtrada = inicio->amplitud;
+        double y_prev = inicio->filtrada;
+
+        NodoSenal* cur = inicio->sig;
+        while (cur) {
+            cur->filtrada = alpha * y_prev + (1 - alpha) * cur->amplitud;
+            y_prev = cur->filtrada;
+            cur = cur->sig;
+        }
+        filtroCalculado(FILTRO_IIR, alpha);
+        cout << "Filtro IIR aplicado.\n";
+    }
+
+    // Filtro FIR (promedio móvil). La señal se parte en trozos que se filtran en paralelo;
+    // cada ventana lee hasta 'radio' muestras de los trozos vecinos (halo) del buffer compartido
+    // y suma en el mismo orden que en serie, así el resultado no depende de los trozos.
+    // No se recalcula si la señal y la ventana no cambiaron
+    void filtroFIR_movingAverage(int ventanaLong = 51) {
+        if (!inicio) return;
+        if (filtroVigente(FILTRO_FIR, ventanaLong)) { cout << "Filtro FIR aplicado.\n"; return; }
+
+        size_t trozos = numTrozos();
+        size_t paso = (tam + trozos - 1) / trozos;
+        vector<double> buffer;
+        vector<NodoSenal*> inicios;      // primer nodo de cada trozo
+        buffer.reserve(tam);
+        inicios.reserve(trozos);
+        for (NodoSenal* p = inicio; p; p = p->sig) {
+            if (buffer.size() % paso == 0) inicios.push_back(p);
+            buffer.push_back(p->amplitud);
+        }
+
+        int N = ventanaLong;
+        int radio = N / 2;
+        int L = 2 * radio + 1;
+        if (L <= 0) L = 1;
+
+        ejecutar(inicios.size(), [&](size_t t) {
+            int a = (int)(t * paso);
+            int b = (int)min(tam, (t + 1) * paso);
+            NodoSenal* p = inicios[t];
+            for (int i = a; i < b; i++, p = p->sig) {
+                double suma = 0;
+                int cuenta = 0;
+                int ini = max(0, i - radio);
+                int fin = min((int)buffer.size() - 1, i + radio);
+
+                for (int k = ini; k <= fin; k++) {
+                    suma += buffer[k];
+                    cuenta++;
+                }
+
+                p->filtrada = (cuenta > 0 ? suma / cuenta : buffer[i]);
+            }
+        });
+        filtroCalculado(FILTRO_FIR, ventanaLong);
+
+        cout << "Filtro FIR aplicado.\n";
+    }
+
+    // Detección de picos básicos (ver asegurarPicos)
+    vector<double> detectarPicos(double umbralMin = 0.5, double refractario_seg = 0.25) {
+        if (tam < 3) return vector<double>();
+        asegurarPicos(umbralMin, refractario_seg);
+        cout << "Picos detectados: " << picos.tiempos.size() << "\n";
+        return picos.tiempos;
+    }
+
+    // Guardar señal procesada
+    bool guardarEnArchivo(const string& nombreSalida) const {
+        ofstream ofs(nombreSalida);
+        if (!ofs.is_open()) {
+            cerr << "Error guardando archivo.\n";
+            return false;
+        }
+
+        ofs << "tiempo\toriginal\tfiltrada\n";
+        for (NodoSenal* p = inicio; p; p = p->sig)
+            ofs << p->tiempo << "\t" << p->amplitud << "\t" << p->filtrada << "\n";
+
+        ofs.close();
+        cout << "Archivo guardado.\n";
+        return true;
+    }
+
+    // Calcular frecuencia cardíaca (reutiliza los picos y los intervalos RR ya calculados)
+    double frecuenciaCardiacaPromedio(double umbralMin = 0.5, double refractario_seg = 0.25) {
+        return resumenRitmo(umbralMin, refractario_seg).bpm;
+    }
+
+    // Frecuencia cardíaca y variabilidad (SDNN, RMSSD, pNN50)
+    ResumenRitmo resumenRitmo(double umbralMin = 0.5, double refractario_seg = 0.25) {
+        if (tam < 3) return ResumenRitmo{0, 0, 0, 0, 0, 0};
+        asegurarPicos(umbralMin, refractario_seg);
+        asegurarRitmo();
+        return ritmo.resumen;
+    }
+
+    // Copia de la señal filtrada (para comparar resultados)
+    vector<double> valoresFiltrados() const {
+        vector<double> v;
+        v.reserve(tam);
+        for (NodoSenal* p = inicio; p; p = p->sig) v.push_back(p->filtrada);
+        return v;
+    }
+
+    // Copia de los tiempos y amplitudes originales
+    void copiarMuestras(vector<double>& t, vector<double>& a) const {
+        t.clear();
+        a.clear();
+        for (NodoSenal* p = inicio; p; p = p->sig) { t.push_back(p->tiempo); a.push_back(p->amplitud); }
+    }
+
+    // Mostrar algunas muestras
+    void debugPrint(int n = 10) const {
+        cout << "Primeras " << n << " muestras:\n";
+        int i = 0;
+        for (NodoSenal* p = inicio; p && i < n; p = p->sig, i++)
+            cout << p->tiempo << "\t" << p->amplitud << "\t" << p->filtrada << "\n";
+    }
+};
+
+// ECG sintética: latidos gaussianos (P, QRS, T) a ~72 lpm con variación y ruido, muestreada a fs Hz
+inline void generarECGSintetica(SenalECG& s, double segundos, double fs = 250.0, unsigned semilla = 1) {
+    mt19937 rng(semilla);
+    normal_distribution<double> ruido(0.0, 0.03);
+    uniform_real_distribution<double> variacion(-0.05, 0.05);
+    double latido = 0.0, rr = 60.0 / 72;
+    size_t n = (size_t)(segundos * fs);
+    for (size_t i = 0; i < n; i++) {
+        double t = i / fs;
+        if (t - latido >= rr) { latido += rr; rr = 60.0 / 72 + variacion(rng); }
+        double x = t - latido;
+        double a = 0.15 * exp(-pow((x - 0.10) / 0.025, 2))    // P
+                 + 1.00 * exp(-pow((x - 0.25) / 0.010, 2))    // QRS
+                 + 0.30 * exp(-pow((x - 0.50) / 0.040, 2));   // T
+        s.insertar(t, a + ruido(rng));
+    }
+}
+
+#endif // SENAL_ECG_H